@@ -8,11 +8,15 @@ Main command-line app by The Cozmonauts.
 
 Usage:
     cozmonaut interact [-a <sera> | --robot-a=<sera>] [-b <serb> | --robot-b=<serb>]
+    cozmonaut bench <frames> [--fps=<fps>] [--identities=<n>] [--loops=<n>]
     cozmonaut (-h | --help | --version)
 
 Options:
-    -h, --help      Show help information.
-    --version       Show version information.
+    -h, --help          Show help information.
+    --version           Show version information.
+    --fps=<fps>         Frame replay rate for the benchmark [default: 15].
+    --identities=<n>    Synthetic identities to seed the store with [default: 1000].
+    --loops=<n>         How many times to replay the frame set [default: 1].
 """
 
 import time
@@ -82,6 +86,43 @@ def do_interact(sera: str, serb: str):
     op.stop()
 
 
+def do_bench(frames: str, fps: str, identities: str, loops: str):
+    """
+    Carry out benchmarking the face pipeline offline.
+
+    This replays a recorded directory of camera frames through the face
+    service without any robots attached, so pipeline changes can be timed
+    on a desk instead of the museum floor.
+
+    :param frames: Directory of recorded camera frames
+    :param fps: Frame replay rate (string from docopt)
+    :param identities: Number of synthetic identities to seed (string from docopt)
+    :param loops: How many times to replay the frame set (string from docopt)
+    """
+
+    # Import here so benchmark parsing errors surface before the heavy load
+    from cozmonaut.operation.interact import bench
+
+    # Parse the numeric options
+    # Docopt hands them over as strings
+    try:
+        fps = float(fps)
+        identities = int(identities)
+        loops = int(loops)
+    except ValueError:
+        print('Benchmark options must be numeric')
+        exit(1)
+
+    # Require a sane replay rate
+    if fps <= 0:
+        print('Need a positive replay rate')
+        exit(1)
+
+    # Run the benchmark in the foreground
+    # There's no terminal interface for this one
+    bench.run(frames, fps=fps, identities=identities, loops=loops)
+
+
 if __name__ == '__main__':
     # Parse command-line arguments
     args = docopt(__doc__, version=__version__)
@@ -92,3 +133,11 @@ if __name__ == '__main__':
             sera=args.get('<sera>') or args.get('--robot-a'),
             serb=args.get('<serb>') or args.get('--robot-b'),
         )
+    elif args['bench']:
+        # Do benchmark mode
+        do_bench(
+            frames=args['<frames>'],
+            fps=args['--fps'],
+            identities=args['--identities'],
+            loops=args['--loops'],
+        )
@@ -11,18 +11,70 @@ import math
 import queue
 import random
 import time
+from collections import deque
 from enum import Enum
 from threading import Lock, Thread
 from typing import Tuple
 
 import cmd2
 import cozmo
+import numpy
 from PIL import Image, ImageDraw
 
 from cozmonaut.operation import Operation
-from cozmonaut.operation.interact import database
+from cozmonaut.operation.interact import database, instrumentation, termlog
+from cozmonaut.operation.interact.recorder import FrameRecorder
 from cozmonaut.operation.interact.service.convo import ServiceConvo
-from cozmonaut.operation.interact.service.face import DetectedFace, RecognizedFace, ServiceFace
+from cozmonaut.operation.interact.service.face import DetectedFace, FaceIdentityStore, RecognizedFace, ServiceFace, \
+    preload_models
+
+
+# The mean time between choreographed activities (in seconds)
+# The choreographer draws activity delays from an exponential distribution
+# with this mean, so something still happens every 90 minutes on average
+_activity_mean_interval = 90 * 60
+
+# How often the sleeping choreographer comes up for air (in seconds)
+# This bounds how stale its battery reading can get; it has no effect on the
+# activity cadence
+_choreographer_wakeup_interval = 5.0
+
+# How long to give each connection's robot handshake at startup (in seconds)
+# A phone that connected but never produces a robot gets cut off after this
+_wait_for_robot_timeout = 15.0
+
+# Where the local identity snapshot lives
+# A cold start maps this instead of waiting on MySQL over the Wi-Fi
+_face_snapshot_directory = 'snapshot'
+
+# How far in front of the cached charger pose to stage (in millimeters)
+# Far enough that the marker fits in frame for validation
+_charger_staging_distance = 150
+
+# How many look-around rounds to try before asking for help
+# Each round costs a spin plus a drive back, so this is the slow path
+_charger_find_max_rounds = 3
+
+# How long to watch for a charger observation in one sitting (in seconds)
+_charger_observe_timeout = 3
+
+# The battery voltage below which a robot must head home
+_battery_low_voltage = 3.5
+
+# How often to sample battery voltage into the history (in seconds)
+_battery_sample_interval = 10.0
+
+# How many voltage samples each robot's history keeps
+# At the sample interval above this is about fifteen minutes of trend
+_battery_history_samples = 90
+
+# How many samples the discharge trend needs before it's trusted
+_battery_trend_min_samples = 6
+
+# How much margin to leave when scheduling a swap (in seconds)
+# The outgoing robot starts its return this far ahead of going flat, which
+# covers the transit back plus the docking dance
+_battery_swap_margin = 300.0
 
 
 class InteractMode(Enum):
@@ -78,6 +130,109 @@ class _RobotAction(Enum):
     drive_from_waypoint_to_charger = 2
 
 
+class _RobotContext:
+    """
+    Everything the operation tracks for one Cozmo robot.
+
+    Adding a robot to the fleet means appending one of these to the context
+    list, not copying every per-robot branch in the operation.
+    """
+
+    def __init__(self, index: int, wanted_serial: str, face_service: ServiceFace):
+        # The robot index (1-based and stable for the life of the operation)
+        self.index = index
+
+        # The robot letter (for operator-facing messages)
+        self.letter = chr(ord('A') + index - 1)
+
+        # The serial number this slot wants
+        self.wanted_serial = wanted_serial
+
+        # The robot instance (assigned during the connection dance)
+        self.robot: cozmo.robot.Robot = None
+
+        # The robot state
+        self.state: _RobotState = None
+
+        # The queue of requested states
+        self.queue = queue.Queue()
+
+        # The saved waypoint
+        self.waypoint: cozmo.util.Pose = None
+
+        # The last known charger pose (cached across trips this session)
+        self.charger_pose: cozmo.util.Pose = None
+
+        # The recent battery voltage history as (time, voltage) samples
+        # The choreographer fits a discharge trend over this to predict when
+        # the robot will go flat
+        self.battery_history = deque(maxlen=_battery_history_samples)
+
+        # The cancel event (created on the interact loop once it exists)
+        self.evt_cancel: asyncio.Event = None
+
+        # The face service for this robot
+        self.service_face = face_service
+
+        # The frame recorder (assigned while recording is on)
+        self.recorder: FrameRecorder = None
+
+
+class _PongRenderer:
+    """
+    A double-buffered renderer for the pong face.
+
+    Two screen-sized buffers and their drawing contexts are allocated once
+    and reused for the life of the game: each frame composes into the back
+    buffer while the front buffer's data may still be on its way to the
+    robot, then the buffers swap. Nothing is allocated per frame, so the
+    50 Hz game loop never stalls on garbage collection.
+    """
+
+    def __init__(self):
+        # The two reusable face buffers and their drawing contexts
+        self._buffers = [Image.new('RGBA', (128, 64), (0, 0, 0, 255)) for _ in range(2)]
+        self._draws = [ImageDraw.Draw(buffer) for buffer in self._buffers]
+
+        # The index of the back buffer (the one to compose into next)
+        self._back = 0
+
+    def render(self, ball_x, ball_y, p1_x, p1_y, p2_x, p2_y):
+        """
+        Compose one frame of the game and convert it to screen format.
+
+        :param ball_x: The ball x-coordinate
+        :param ball_y: The ball y-coordinate
+        :param p1_x: The left paddle x-offset
+        :param p1_y: The left paddle y-coordinate
+        :param p2_x: The right paddle x-offset
+        :param p2_y: The right paddle y-coordinate
+        :return: The frame as OLED screen data
+        """
+
+        draw = self._draws[self._back]
+
+        # Clear the back buffer
+        draw.rectangle([0, 0, 128, 64], fill=(0, 0, 0, 255))
+
+        # Draw ball
+        draw.ellipse([ball_x - 5, ball_y - 5, ball_x + 5, ball_y + 5], fill=(255, 255, 255, 255))
+
+        # Draw paddle 1 (left)
+        draw.rectangle([p1_x + 3, p1_y - 10, p1_x, p1_y + 10], fill=(255, 255, 255, 255))
+
+        # Draw paddle 2 (right)
+        draw.rectangle([p2_x - 3, p2_y - 10, p2_x, p2_y + 10], fill=(255, 255, 255, 255))
+
+        # Convert the back buffer to the 1-bit screen format
+        screen = cozmo.oled_face.convert_image_to_screen_data(self._buffers[self._back])
+
+        # Swap buffers for the next frame
+        self._back = 1 - self._back
+
+        return screen
+
+
 class OperationInteract(Operation):
     """
     The interact operation.
@@ -132,12 +287,20 @@ class OperationInteract(Operation):
         # An indicator telling if the low-level functionality should shut down (not thread-safe)
         self._stopping = False
 
-        # Indicators telling if the current activity should cancel for each Cozmo robot
-        self._cancel_a = False
-        self._cancel_b = False
+        # The interact event loop (created by the interact thread)
+        self._loop: asyncio.AbstractEventLoop = None
+
+        # An event telling if the activity is completed
+        self._evt_complete: asyncio.Event = None
+
+        # An event mirroring the kill switch for coroutines to sleep on
+        self._evt_should_stop: asyncio.Event = None
 
-        # An indicator telling if the activity is completed
-        self._complete = False
+        # An event that fires whenever the override flag is toggled
+        self._evt_override_changed: asyncio.Event = None
+
+        # An event that fires when a prompted name comes back
+        self._evt_prompted_name: asyncio.Event = None
 
         # An indicator telling if we should swap
         # This is only ever when poking around manually (but never in manual override mode)
@@ -146,6 +309,16 @@ class OperationInteract(Operation):
         self._swap = False
         self._swap_lock = Lock()
 
+        # The upcoming activity schedule
+        # The choreographer samples the next activity and its time up front
+        # and sleeps until then; the terminal can query these at any time
+        self._next_activity: str = None
+        self._next_activity_time: float = None
+
+        # The periodic stats line interval (in seconds; None means off)
+        # The terminal toggles this through set_stats_interval
+        self._stats_interval: float = None
+
         # Manual override mode
         # In manual override, neither Cozmo is doing its own thing
         self._override = False
@@ -154,25 +327,20 @@ class OperationInteract(Operation):
         # The conversation service
         self._service_convo = ServiceConvo()
 
-        # The face services for robots
-        self._service_face_a = ServiceFace()
-        self._service_face_b = ServiceFace()
-
-        # The robot instances
-        self._robot_a: cozmo.robot.Robot = None
-        self._robot_b: cozmo.robot.Robot = None
-
-        # States for the robots
-        self._robot_state_a: _RobotState = None
-        self._robot_state_b: _RobotState = None
-
-        # Queues for robot actions
-        self._robot_queue_a = queue.Queue()
-        self._robot_queue_b = queue.Queue()
-
-        # Waypoints for the robots
-        self._robot_waypoint_a: cozmo.util.Pose = None
-        self._robot_waypoint_b: cozmo.util.Pose = None
+        # The shared face identity store
+        # All per-robot face services recognize out of this one copy
+        self._face_identity_store = FaceIdentityStore()
+
+        # The per-robot contexts
+        # Everything specific to one robot lives in its context, so the fleet
+        # grows by appending here rather than by copying branches
+        # The face services log through the batching terminal writer under
+        # the 'face' subsystem, so their chatter can be muted in one command
+        face_log = functools.partial(termlog.emit, 'face')
+        self._contexts = [
+            _RobotContext(1, self._wanted_serial_a, ServiceFace(self._face_identity_store, log=face_log)),
+            _RobotContext(2, self._wanted_serial_b, ServiceFace(self._face_identity_store, log=face_log)),
+        ]
 
     def start(self):
         """
@@ -196,6 +364,14 @@ class OperationInteract(Operation):
         with self._should_stop_lock:
             self._should_stop = True
 
+        # Wake up anything sleeping on the stop event
+        # The event lives on the interact loop, so we go through it thread-safely
+        if self._loop is not None and self._evt_should_stop is not None:
+            try:
+                self._loop.call_soon_threadsafe(self._evt_should_stop.set)
+            except RuntimeError:
+                pass  # The loop already shut down, which is fine by us
+
         # Wait for the interact thread to die
         if self._thread_interact is not None:
             self._thread_interact.join()
@@ -232,9 +408,29 @@ class OperationInteract(Operation):
         """
 
         try:
+            # Start the batching log writer
+            # From here on, terminal prints are one ring append on the hot
+            # path and one terminal alert per flush on the writer thread
+            termlog.start(self._term_alert)
+
             # Create an event loop for interaction
             loop = asyncio.new_event_loop()
 
+            # Make it the event loop for this thread
+            asyncio.set_event_loop(loop)
+
+            # Publish the loop for thread-safe signalling
+            self._loop = loop
+
+            # Create the coordination events on this loop
+            # Coroutines sleep on these instead of spinning on flags
+            for ctx in self._contexts:
+                ctx.evt_cancel = asyncio.Event()
+            self._evt_complete = asyncio.Event()
+            self._evt_should_stop = asyncio.Event()
+            self._evt_override_changed = asyncio.Event()
+            self._evt_prompted_name = asyncio.Event()
+
             # Print some stuff about the mode
             if self._mode == InteractMode.both:
                 self._tprint('Configured for both Cozmos A and B')
@@ -247,6 +443,25 @@ class OperationInteract(Operation):
                 self._tprint('Configured for just Cozmo B')
                 self._tprint(f'Want Cozmo B to have serial number {self._wanted_serial_b}')
 
+            # Start loading the face models in the background
+            # The connection dance below takes a while, so by the time the
+            # face services need them the load has already finished
+            thread_models = Thread(target=preload_models, name='ModelPreload', daemon=True)
+            thread_models.start()
+
+            # Try the local identity snapshot first
+            # One mmap seeds the store with yesterday's identities, and the
+            # background loader below reconciles the store against MySQL
+            snapped = self._face_identity_store.load_snapshot(_face_snapshot_directory)
+            if snapped:
+                self._tprint(f'Mapped {snapped} known face(s) from the local snapshot')
+
+            # Start streaming known faces from the database in the background
+            # The identity store is lock-guarded, so recognition can match
+            # against the rows loaded so far while the tail is still arriving
+            thread_faces = Thread(target=self._load_known_faces, name='FaceLoad', daemon=True)
+            thread_faces.start()
+
             self._tprint('Establishing as many connections as possible')
 
             # A list of connections we've made
@@ -274,104 +489,70 @@ class OperationInteract(Operation):
                 # Keep the connection
                 connections.insert(i, conn)
 
-            # Go over all the connections we've made
-            for i in range(0, len(connections)):
-                conn = connections[i]
+            # The serials we still want, mapped to their robot contexts
+            # Handshakes pop their serial out of here as they claim a slot
+            wanted_serials = {ctx.wanted_serial: ctx for ctx in self._wanted_contexts()}
 
-                # Whether or not to keep the connection
-                # We only keep the ones we need, but we don't know which those are until we've connected to everyone
-                keep = False
+            async def handshake(i: int, conn):
+                """
+                Wait for the robot on one connection and sort it out.
 
-                # Wait for the robot on this connection
-                robot = loop.run_until_complete(conn.wait_for_robot())
+                Unneeded connections abort the moment their serial is known,
+                and a connection that never produces a robot gets cut off by
+                the handshake timeout.
 
-                self._tprint(f'Robot on connection #{i} has serial number {robot.serial}')
-
-                # If we're assigning both Cozmos
-                if self._mode == InteractMode.both:
-                    # If this serial matches that desired for robot A
-                    if robot.serial == self._wanted_serial_a:
-                        # Keep the connection
-                        keep = True
-
-                        # Assign robot A
-                        self._robot_a = robot
-
-                        self._tprint(
-                            f'On connection #{i}, robot A was assigned serial number {robot.serial} (need A and B)')
-
-                    # If this serial matches that desired for robot B
-                    if robot.serial == self._wanted_serial_b:
-                        # Keep the connection
-                        keep = True
-
-                        # Assign robot B
-                        self._robot_b = robot
-
-                        self._tprint(
-                            f'On connection #{i}, robot B was assigned serial number {robot.serial} (need A and B)')
+                :param i: The connection index
+                :param conn: The connection
+                """
 
-                # If we're assigning just Cozmo A
-                if self._mode == InteractMode.just_a:
-                    # If this serial matches that desired for robot A
-                    if robot.serial == self._wanted_serial_a:
-                        # Keep the connection
-                        keep = True
-
-                        # Assign robot A
-                        self._robot_a = robot
+                try:
+                    # Wait for the robot, but not forever
+                    robot = await asyncio.wait_for(conn.wait_for_robot(), timeout=_wait_for_robot_timeout)
+                except asyncio.TimeoutError:
+                    self._tprint(f'Connection #{i} did not produce a robot in time, so disconnecting it')
 
-                        self._tprint(
-                            f'On connection #{i}, robot A was assigned serial number {robot.serial} (need just A)')
+                    # Abort the connection
+                    conn.abort(0)
+                    return
 
-                # If we're assigning just Cozmo B
-                if self._mode == InteractMode.just_b:
-                    # If this serial matches that desired for robot B
-                    if robot.serial == self._wanted_serial_b:
-                        # Keep the connection
-                        keep = True
+                self._tprint(f'Robot on connection #{i} has serial number {robot.serial}')
 
-                        # Assign robot B
-                        self._robot_b = robot
+                # Try to claim a robot context for this serial
+                # All handshakes run on the one event loop, so no lock needed
+                ctx = wanted_serials.pop(robot.serial, None)
 
-                        self._tprint(
-                            f'On connection #{i}, robot B was assigned serial number {robot.serial} (need just B)')
+                if ctx is not None:
+                    # Assign the robot to its context
+                    ctx.robot = robot
 
-                # If we're not keeping this connection
-                if not keep:
+                    self._tprint(f'On connection #{i}, robot {ctx.letter} was assigned serial number {robot.serial}')
+                else:
                     self._tprint(f'Connection #{i} is not needed, so disconnecting it')
 
                     # Abort the connection
                     conn.abort(0)
 
-            # Stop if we're missing a Cozmo
-            if self._mode == InteractMode.both:
-                # Whether or not one is missing
-                missing = False
+            # Run all the handshakes concurrently
+            # Startup now costs the slowest single handshake instead of the sum
+            loop.run_until_complete(asyncio.gather(
+                *(handshake(i, conn) for i, conn in enumerate(connections)),
+                loop=loop,
+            ))
 
-                # Look at A
-                if self._robot_a is None:
-                    missing = True
-                    self._tprint('Configured for both, but Cozmo A is missing')
+            # Stop if we're missing a Cozmo
+            # Whether or not one is missing
+            missing = False
 
-                # Look at B
-                if self._robot_b is None:
+            # Look at every wanted robot
+            for ctx in self._wanted_contexts():
+                if ctx.robot is None:
                     missing = True
-                    self._tprint('Configured for both, but Cozmo B is missing')
+                    self._tprint(f'Cozmo {ctx.letter} is missing')
 
-                # If one is missing
-                if missing:
-                    self._tprint('At least one Cozmo is missing, so refusing to continue')
-                    return
-            elif self._mode == InteractMode.just_a:
-                # Look at A
-                if self._robot_a is None:
-                    self._tprint('Cozmo A is missing, so refusing to continue')
-                    return
-            elif self._mode == InteractMode.just_b:
-                # Look at B
-                if self._robot_b is None:
-                    self._tprint('Cozmo B is missing, so refusing to continue')
+            # If one is missing
+            if missing:
+                self._tprint('At least one Cozmo is missing, so refusing to continue')
+                return
 
             self._tprint('Beginning interactive procedure')
 
@@ -379,22 +560,27 @@ class OperationInteract(Operation):
             self._tprint('| IMPORTANT: We are assuming both Cozmos start on their chargers! |')
             self._tprint('+-----------------------------------------------------------------+')
 
-            # Assume both Cozmos start on their chargers (as advertised ^^^)
-            self._robot_state_a = _RobotState.home
-            self._robot_state_b = _RobotState.home
+            # Assume all Cozmos start on their chargers (as advertised ^^^)
+            for ctx in self._contexts:
+                ctx.state = _RobotState.home
 
             tasks = asyncio.gather(
                 # The watchdog coroutine handles the shutdown protocol
                 self._watchdog(),
 
-                # Driver coroutines for Cozmos A and B
+                # One driver coroutine per robot in the fleet
                 # These routines take care of running individual bite-size tasks
-                self._driver(1, self._robot_a),
-                self._driver(2, self._robot_b),
+                *(self._driver(ctx) for ctx in self._contexts),
 
                 # The choreographer coroutine automates the robots from a high level
                 self._choreographer(),
 
+                # The stats reporter prints a periodic summary line when enabled
+                self._stats_reporter(),
+
+                # The battery monitor samples voltage history for swap prediction
+                self._battery_monitor(),
+
                 # Explicitly provide our event loop
                 # Without this, there will be an error along the lines of "no current event loop"
                 loop=loop,
@@ -402,32 +588,17 @@ class OperationInteract(Operation):
 
             self._tprint('Setting up face services')
 
-            # Create face services
-            self._service_face_a = ServiceFace()
-            self._service_face_b = ServiceFace()
+            # Start the write-behind journal for sightings and inserts
+            database.startJournal()
 
-            self._tprint('Loading known faces from database')
+            # Start the face services
+            for ctx in self._contexts:
+                ctx.service_face.start()
 
-            # Query known faces from database
-            known_faces = database.loadStudents()
-
-            # If there are known faces
-            if known_faces is not None:
-                # Loop through them
-                # We received their IDs and string-encoded identities from the database
-                for (fid, ident_enc) in known_faces:
-                    # Decode string-encoded identity
-                    # The result is a 128-tuple of 64-bit floats
-                    ident = self._face_ident_decode(ident_enc)
-
-                    # Register identity with both face services
-                    # That way both Cozmos will be able to recognize the face
-                    self._service_face_a.add_identity(fid, ident)
-                    self._service_face_b.add_identity(fid, ident)
-
-            # Stop the face services
-            self._service_face_a.start()
-            self._service_face_b.start()
+            # Start the convo service
+            # This precompiles every conversation, so starting one later is
+            # just a dictionary lookup
+            self._service_convo.start()
 
             # Run the event loop until it stops (it's not actually forever)
             loop.run_forever()
@@ -436,15 +607,134 @@ class OperationInteract(Operation):
             loop.run_until_complete(tasks)
 
             # Stop the face services
-            self._service_face_a.stop()
-            self._service_face_b.stop()
+            for ctx in self._contexts:
+                ctx.service_face.stop()
+
+            # Stop the convo service
+            self._service_convo.stop()
+
+            # Flush and stop any frame recorders still running
+            self.stop_recording()
+
+            # Flush and stop the write-behind journal
+            database.stopJournal()
+
+            # Write the local identity snapshot for the next cold start
+            try:
+                self._face_identity_store.save_snapshot(_face_snapshot_directory)
+                self._tprint('Saved the local identity snapshot')
+            except OSError as e:
+                self._tprint(f'Failed to save the local identity snapshot: {e}')
 
             self._tprint('Goodbye!')
         finally:
+            # Flush and stop the log writer
+            termlog.stop()
+
             # Set the stopped flag
             with self._stopped_lock:
                 self._stopped = True
 
+    def _context(self, index: int) -> _RobotContext:
+        """
+        Get the context for a robot.
+
+        :param index: The robot index
+        :return: The robot context, or None for an unknown index
+        """
+
+        if 1 <= index <= len(self._contexts):
+            return self._contexts[index - 1]
+
+        return None
+
+    def _wanted_contexts(self):
+        """
+        Get the contexts for the robots the mode actually wants.
+
+        :return: A list of robot contexts
+        """
+
+        if self._mode == InteractMode.just_a:
+            return [self._contexts[0]]
+        elif self._mode == InteractMode.just_b:
+            return [self._contexts[1]]
+
+        return list(self._contexts)
+
+    def _cancel_event(self, index: int) -> asyncio.Event:
+        """
+        Get the cancel event for a robot.
+
+        :param index: The robot index
+        :return: The cancel event
+        """
+
+        return self._context(index).evt_cancel
+
+    def request_cancel(self, index: int):
+        """
+        Request cancellation of the current activity on a robot.
+
+        This is safe to call from any thread.
+
+        :param index: The robot index
+        """
+
+        # The cancel event for this robot
+        evt = self._cancel_event(index)
+
+        # Fire the event on the interact loop
+        if self._loop is not None and evt is not None:
+            try:
+                self._loop.call_soon_threadsafe(evt.set)
+            except RuntimeError:
+                pass  # The loop already shut down, so there's nothing to cancel
+
+    def _check_cancel(self, index: int) -> bool:
+        """
+        Consume a pending cancel request for a robot, if any.
+
+        :param index: The robot index
+        :return: True if a cancel was pending, otherwise False
+        """
+
+        # The cancel event for this robot
+        evt = self._cancel_event(index)
+
+        # If a cancel is pending, consume it
+        if evt.is_set():
+            evt.clear()
+            return True
+
+        return False
+
+    def notify_override_changed(self):
+        """
+        Notify coroutines that the override flag was toggled.
+
+        This is safe to call from any thread.
+        """
+
+        if self._loop is not None and self._evt_override_changed is not None:
+            try:
+                self._loop.call_soon_threadsafe(self._evt_override_changed.set)
+            except RuntimeError:
+                pass  # The loop already shut down
+
+    def notify_prompted_name(self):
+        """
+        Notify coroutines that a prompted name has come back.
+
+        This is safe to call from any thread.
+        """
+
+        if self._loop is not None and self._evt_prompted_name is not None:
+            try:
+                self._loop.call_soon_threadsafe(self._evt_prompted_name.set)
+            except RuntimeError:
+                pass  # The loop already shut down
+
     async def _watchdog(self):
         """
         The watchdog handles shutdown requests.
@@ -452,90 +742,73 @@ class OperationInteract(Operation):
 
         self._tprint('Watchdog has started')
 
-        while not self._almost_stopping:
-            # Check if we should stop
-            # There shouldn't be much contention on this lock
-            with self._should_stop_lock:
-                should_stop = self._should_stop
+        # Check the flag once in case stop was requested before the loop was up
+        with self._should_stop_lock:
+            should_stop = self._should_stop
 
-            # If we should stop, start stopping
-            if should_stop:
-                # Set the stopping indicator
-                # All high-level loops should start shutting down
-                self._almost_stopping = True
+        # Sleep until the stop event fires
+        # The event loop is totally idle while we wait
+        if not should_stop:
+            await self._evt_should_stop.wait()
 
-                # Get the event loop
-                loop = asyncio.get_event_loop()
+        # Set the stopping indicator
+        # All high-level loops should start shutting down
+        self._almost_stopping = True
 
-                # Politely ask the loop to stop soon
-                loop.call_soon(loop.stop)
+        # Get the event loop
+        loop = asyncio.get_event_loop()
 
-                self._tprint('The event loop will stop soon')
-            else:
-                # Yield control
-                await asyncio.sleep(0)
+        # Politely ask the loop to stop soon
+        loop.call_soon(loop.stop)
+
+        self._tprint('The event loop will stop soon')
 
         self._tprint('Watchdog has stopped')
 
-    async def _driver(self, index: int, robot: cozmo.robot.Robot):
+    async def _driver(self, ctx: _RobotContext):
         """
         The driver for a single robot.
 
-        :param index: The robot index (1 for robot A or 2 for robot B)
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
-
-        self._tprint(f'Driver for robot {letter} has started')
+        self._tprint(f'Driver for robot {ctx.letter} has started')
 
         # Stop if this driver is not needed
-        if robot is None:
-            self._tprint(f'Robot {letter} is not available, so driver {letter} is stopping')
+        if ctx.robot is None:
+            self._tprint(f'Robot {ctx.letter} is not available, so driver {ctx.letter} is stopping')
             return
 
+        # The robot instance
+        robot = ctx.robot
+
         # Enable color imaging on the robot
         robot.camera.color_image_enabled = True
         robot.camera.image_stream_enabled = True
 
         # Listen for camera frames from this Cozmo
-        # We create a partially-bound function that sneaks in our index and robot parameters
+        # We create a partially-bound function that sneaks in our context parameter
         robot.camera.add_event_handler(cozmo.robot.camera.EvtNewRawCameraImage,
-                                       functools.partial(self._driver_on_evt_new_raw_camera_image, index, robot))
-
-        # Get the robot-specific data
-        state_queue = None
-        service_face = None
-        if index == 1:
-            state_queue = self._robot_queue_a
-            service_face = self._service_face_a
-        elif index == 2:
-            state_queue = self._robot_queue_b
-            service_face = self._service_face_b
+                                       functools.partial(self._driver_on_evt_new_raw_camera_image, ctx))
 
         # Start the face service
-        service_face.start()
+        ctx.service_face.start()
 
         while not self._stopping:  # Low-level loop (this needs to outlive the choreographer)
-            # Yield control
-            await asyncio.sleep(0)
-
             # Try to get the next state
             state_next: _RobotState = None
             try:
-                state_next = state_queue.get_nowait()
+                state_next = ctx.queue.get_nowait()
             except queue.Empty:
-                pass
+                # Doze briefly instead of spinning
+                # State requests arrive at human speed, so this is plenty fast
+                await asyncio.sleep(0.05)
+                continue
 
             # If a state was dequeued
             if state_next is not None:
                 # Get the current state
-                state_current = None
-                if index == 1:
-                    state_current = self._robot_state_a
-                elif index == 2:
-                    state_current = self._robot_state_b
+                state_current = ctx.state
 
                 # The state we actually ended up going to
                 # By default, this is the current state
@@ -551,76 +824,73 @@ class OperationInteract(Operation):
                         state_final = state_next
 
                         # Drive from the charger to the waypoint
-                        task = asyncio.ensure_future(self._do_drive_from_charger_to_waypoint(index, robot))
+                        task = asyncio.ensure_future(self._do_drive_from_charger_to_waypoint(ctx))
                 elif state_current == _RobotState.waypoint:
                     if state_next == _RobotState.home:
                         # GOTO waypoint -> home
                         state_final = state_next
 
                         # Drive from the waypoint to the charger
-                        task = asyncio.ensure_future(self._do_drive_from_waypoint_to_charger(index, robot))
+                        task = asyncio.ensure_future(self._do_drive_from_waypoint_to_charger(ctx))
                     elif state_next == _RobotState.convo:
                         # GOTO waypoint -> convo
                         state_final = state_next
 
                         # Carry out the conversation
-                        task = asyncio.ensure_future(self._do_convo(index, robot))
+                        task = asyncio.ensure_future(self._do_convo(ctx))
                     elif state_next == _RobotState.greet:
                         # GOTO waypoint -> greet
                         state_final = state_next
 
                         # Carry out greeting
-                        task = asyncio.ensure_future(self._do_meet_and_greet(index, robot))
+                        task = asyncio.ensure_future(self._do_meet_and_greet(ctx))
                     elif state_next == _RobotState.freeplay:
                         # GOTO waypoint -> freeplay
                         state_final = state_next
 
                         # Carry out freeplay
-                        task = asyncio.ensure_future(self._do_freeplay(index, robot))
+                        task = asyncio.ensure_future(self._do_freeplay(ctx))
                     elif state_next == _RobotState.pong:
                         # GOTO waypoint -> pong
                         state_final = state_next
 
                         # Carry out pong
-                        task = asyncio.ensure_future(self._do_pong(index, robot))
+                        task = asyncio.ensure_future(self._do_pong(ctx))
                 elif state_current == _RobotState.convo:
                     if state_next == _RobotState.waypoint:
                         # GOTO convo -> waypoint
                         state_final = state_next
 
                         # Return to the waypoint
-                        task = asyncio.ensure_future(self._do_return_to_waypoint(index, robot))
+                        task = asyncio.ensure_future(self._do_return_to_waypoint(ctx))
                 elif state_current == _RobotState.greet:
                     if state_next == _RobotState.waypoint:
                         # GOTO greet -> waypoint
                         state_final = state_next
 
                         # Return to the waypoint
-                        task = asyncio.ensure_future(self._do_return_to_waypoint(index, robot))
+                        task = asyncio.ensure_future(self._do_return_to_waypoint(ctx))
                 elif state_current == _RobotState.freeplay:
                     if state_next == _RobotState.waypoint:
                         # GOTO freeplay -> waypoint
                         state_final = state_next
 
                         # Return to the waypoint
-                        task = asyncio.ensure_future(self._do_return_to_waypoint(index, robot))
+                        task = asyncio.ensure_future(self._do_return_to_waypoint(ctx))
                 elif state_current == _RobotState.pong:
                     if state_next == _RobotState.waypoint:
                         # GOTO pong -> waypoint
                         state_final = state_next
 
                         # Return to the waypoint
-                        task = asyncio.ensure_future(self._do_return_to_waypoint(index, robot))
+                        task = asyncio.ensure_future(self._do_return_to_waypoint(ctx))
 
                 # If the state did not change
                 if state_final == state_current:
                     self._tprint(f'Failed to transition from state "{state_current.name}" to state "{state_next.name}"')
 
                 # Update the current state
-                if index == 1:
-                    self._robot_state_a = state_final
-                elif index == 2:
-                    self._robot_state_b = state_final
+                ctx.state = state_final
 
                 if task is not None:
                     # Wait for the task
@@ -628,48 +898,42 @@ class OperationInteract(Operation):
                     await task
 
         # Stop the face service
-        service_face.stop()
+        ctx.service_face.stop()
 
-        self._tprint(f'Driver for robot {letter} has stopped')
+        self._tprint(f'Driver for robot {ctx.letter} has stopped')
 
-    def _driver_on_evt_new_raw_camera_image(self, index: int, robot: cozmo.robot.Robot,
+    def _driver_on_evt_new_raw_camera_image(self, ctx: _RobotContext,
                                             evt: cozmo.robot.camera.EvtNewRawCameraImage, **kwargs):
         """
         Called by the Cozmo SDK when a camera frame comes in.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         :param evt: The handled event
         :param kwargs: Excess keyword arguments
         """
 
-        # The camera frame image
-        image = evt.image
-
-        # The face service for this Cozmo robot
-        face: ServiceFace = None
-
-        # Pick the corresponding face service
-        if index == 1:
-            face = self._service_face_a
-        elif index == 2:
-            face = self._service_face_b
-
         # Update the Cozmo-corresponding face service with the new camera frame
-        face.update(image)
+        # The callback is timed so a regression here shows up in the stats
+        with instrumentation.timed('interact.camera_callback'):
+            ctx.service_face.update(evt.image)
 
-    async def _do_drive_from_charger_to_waypoint(self, index: int, robot: cozmo.robot.Robot):
+            # Hand the frame to the recorder if one is on
+            # This is a single non-blocking ring push
+            recorder = ctx.recorder
+            if recorder is not None:
+                recorder.submit(evt.image)
+
+    async def _do_drive_from_charger_to_waypoint(self, ctx: _RobotContext):
         """
         Action for driving from charger to waypoint.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
+        # The robot instance
+        robot = ctx.robot
 
-        self._tprint(f'Robot {letter} is departing from charger and heading to waypoint')
+        self._tprint(f'Robot {ctx.letter} is departing from charger and heading to waypoint')
 
         # Drive off the charger contacts
         await robot.drive_off_charger_contacts().wait_for_completed()
@@ -681,23 +945,24 @@ class OperationInteract(Operation):
         ).wait_for_completed()
 
         # Save robot waypoint
-        if index == 1:
-            self._robot_waypoint_a = robot.pose
-        elif index == 2:
-            self._robot_waypoint_b = robot.pose
+        ctx.waypoint = robot.pose
+
+        # Remember where the charger is for the trip back
+        # We just drove off it, so the engine knows exactly where it sits
+        if robot.world.charger is not None and robot.world.charger.pose.is_comparable(robot.pose):
+            ctx.charger_pose = self._charger_pose_copy(robot.world.charger.pose)
 
-    async def _do_drive_from_waypoint_to_charger(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_drive_from_waypoint_to_charger(self, ctx: _RobotContext):
         """
         Action for driving from waypoint to charger.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
+        # The robot instance
+        robot = ctx.robot
 
-        self._tprint(f'Robot {letter} is departing from waypoint and heading to charger')
+        self._tprint(f'Robot {ctx.letter} is departing from waypoint and heading to charger')
 
         # Turn toward the charger
         await robot.turn_in_place(cozmo.util.degrees(180)).wait_for_completed()
@@ -716,7 +981,7 @@ class OperationInteract(Operation):
         pitch_threshold = math.fabs(robot.pose_pitch.degrees) + 1
 
         # Drive to the charger
-        await self._charger_return_go_to_charger_coarse(robot)
+        await self._charger_return_go_to_charger_coarse(ctx)
 
         # If the charger location is known (it should be)
         if robot.world.charger is not None:
@@ -823,8 +1088,12 @@ class OperationInteract(Operation):
         else:
             self._tprint('The charger was not detected! Assuming we\'re on it?')  # TODO: What do? Call for help...
 
-        # Set completed flag
-        self._complete = True
+        # Refresh the cached charger pose for the next trip
+        if robot.world.charger is not None and robot.world.charger.pose.is_comparable(robot.pose):
+            ctx.charger_pose = self._charger_pose_copy(robot.world.charger.pose)
+
+        # Fire the completion event
+        self._evt_complete.set()
 
         #
         # END INTEGRATED CHARGER RETURN CODE
@@ -835,6 +1104,12 @@ class OperationInteract(Operation):
         """
         Locate the nearest charger from the perspective of a robot.
 
+        This is the slow path, taken only when the cached pose didn't pan
+        out: a quick stationary peek, then a bounded number of look-around
+        rounds, and finally a stand-still-and-ask-for-help loop. Holding
+        still beats spinning in place once the rounds run out, since the
+        spin burns battery without finding anything new.
+
         Part of the driver routine for a single Cozmo robot.
 
         :param robot: The robot instance
@@ -842,14 +1117,18 @@ class OperationInteract(Operation):
 
         self._tprint('Starting to look for the charger')
 
-        rnd = 1
+        # A stationary peek first
+        # From staging the marker is usually already in frame, and this saves
+        # a whole look-around round when it is
+        try:
+            return await robot.world.wait_for_observed_charger(timeout=_charger_observe_timeout,
+                                                               include_existing=True)
+        except cozmo.exceptions.CozmoSDKException:
+            pass
 
-        # Be persistent, Cozmo!
-        while True:
+        for rnd in range(1, _charger_find_max_rounds + 1):
             self._tprint(f'Look for charger (round {rnd})')
 
-            rnd += 1
-
             # Remember the robot pose before looking around
             pose_before = robot.pose
 
@@ -877,25 +1156,81 @@ class OperationInteract(Operation):
             if seen_charger is not None:
                 self._tprint('The charger was found!')
                 return seen_charger
-            else:
-                self._tprint('The charger was not found! :(')
 
-                # Play frustrated animation
-                await robot.play_anim_trigger(cozmo.anim.Triggers.FrustratedByFailureMajor).wait_for_completed()
+            self._tprint('The charger was not found! :(')
+
+        # Out of rounds, so ask for help and hold still
+        # A human can straighten out whatever went wrong
+        await robot.play_anim_trigger(cozmo.anim.Triggers.FrustratedByFailureMajor).wait_for_completed()
+
+        while True:
+            await robot.say_text('A little help?').wait_for_completed()
 
-                # Ask for help
-                # TODO: Is is okay that this happens here? I know we talked about asking for help...
-                await robot.say_text('A little help?').wait_for_completed()
+            try:
+                return await robot.world.wait_for_observed_charger(timeout=30, include_existing=True)
+            except cozmo.exceptions.CozmoSDKException:
+                pass
 
-    async def _charger_return_go_to_charger_coarse(self, robot: cozmo.robot.Robot):
+    async def _charger_return_drive_to_cached(self, ctx: _RobotContext) -> cozmo.objects.Charger:
         """
-        Coarsely drive a robot up to the first seen charger.
+        Drive toward the cached charger pose, validating it on the way.
 
-        This ballparks it. There must be further correction.
+        The drive stages in front of where the charger was last seen, and
+        the engine scans the already-flowing camera stream for the marker
+        the whole way. If the marker shows up where expected, the cache is
+        validated and the return can go straight to fine alignment with no
+        look-around at all.
 
-        :param robot: The robot instance
+        :param ctx: The robot context
+        :return: The charger if the cache validated, otherwise None
         """
 
+        robot = ctx.robot
+        pose = ctx.charger_pose
+
+        self._tprint(f'Robot {ctx.letter} is driving to the cached charger pose')
+
+        # Compute a staging pose in front of the cached charger pose
+        # Facing the charger keeps the marker in frame during the approach
+        rot = pose.rotation.angle_z.radians
+        staging = cozmo.util.pose_z_angle(
+            pose.position.x - _charger_staging_distance * math.cos(rot),
+            pose.position.y - _charger_staging_distance * math.sin(rot),
+            pose.position.z,
+            cozmo.util.radians(rot),
+            origin_id=pose.origin_id,
+        )
+
+        # Start the drive and watch for the marker while it runs
+        action = robot.go_to_pose(staging)
+        try:
+            await robot.world.wait_for_observed_charger(timeout=10, include_existing=False)
+        except cozmo.exceptions.CozmoSDKException:
+            pass
+        await action.wait_for_completed()
+
+        # The cache validated if the marker showed up where expected
+        if robot.world.charger is not None and robot.world.charger.pose.is_comparable(robot.pose):
+            self._tprint('The cached charger pose validated')
+            return robot.world.charger
+
+        self._tprint('The cached charger pose did not validate')
+        return None
+
+    async def _charger_return_go_to_charger_coarse(self, ctx: _RobotContext):
+        """
+        Coarsely drive a robot up to the charger.
+
+        This ballparks it. There must be further correction. The last known
+        charger pose is cached across trips, so most returns skip the
+        look-around hunt entirely.
+
+        :param ctx: The robot context
+        """
+
+        # The robot instance
+        robot = ctx.robot
+
         # The charger reference
         charger = None
 
@@ -909,11 +1244,18 @@ class OperationInteract(Operation):
                 # Just take the charger reference
                 charger = robot.world.charger
 
+        # If the engine doesn't know, try the pose cached from the last trip
+        if charger is None and ctx.charger_pose is not None and ctx.charger_pose.is_comparable(robot.pose):
+            charger = await self._charger_return_drive_to_cached(ctx)
+
         # If we don't yet have the charger reference
         if not charger:
             # Find the charger
             charger = await self._charger_return_find_charger(robot)
 
+        # Remember where the charger was for the next trip
+        ctx.charger_pose = self._charger_pose_copy(charger.pose)
+
         # Drive to the charger the first time
         # This is a ballpark maneuver; we'll fine-tune it next
         await robot.go_to_object(
@@ -922,6 +1264,22 @@ class OperationInteract(Operation):
             num_retries=5
         ).wait_for_completed()
 
+    @staticmethod
+    def _charger_pose_copy(pose: cozmo.util.Pose) -> cozmo.util.Pose:
+        """
+        Copy a pose so the SDK can't invalidate our cached copy in place.
+
+        :param pose: The pose to copy
+        :return: An independent copy of the pose
+        """
+
+        return cozmo.util.Pose(
+            pose.position.x, pose.position.y, pose.position.z,
+            q0=pose.rotation.q0, q1=pose.rotation.q1,
+            q2=pose.rotation.q2, q3=pose.rotation.q3,
+            origin_id=pose.origin_id,
+        )
+
     async def _charger_return_go_to_charger_fine(self, robot: cozmo.robot.Robot):
         """
         The fine part of charger goto functionality.
@@ -1029,32 +1387,27 @@ class OperationInteract(Operation):
 
         return angle
 
-    async def _do_convo(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_convo(self, ctx: _RobotContext):
         """
         Action for carrying out a conversation.
 
         Data:
           - name (str) The conversation name
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
+        # The robot instance
+        robot = ctx.robot
 
-        self._tprint(f'Robot {letter} is engaging in conversation')
+        self._tprint(f'Robot {ctx.letter} is engaging in conversation')
 
         # Turn toward other Cozmo
         # TODO: Use the index to determine angle to look at other Cozmo
         await robot.turn_in_place(cozmo.util.degrees(180)).wait_for_completed()
 
         # Get the requested conversation
-        name = None
-        if index == 1:
-            name = self._robot_queue_a.get()
-        elif index == 2:
-            name = self._robot_queue_b.get()
+        name = ctx.queue.get()
 
         self._tprint(f'Requested conversation {name}')
 
@@ -1069,77 +1422,49 @@ class OperationInteract(Operation):
             fut = asyncio.ensure_future(convo.perform(
                 # One of these may be None, but that's okay
                 # The service will take care of handling that
-                robot_a=self._robot_a,
-                robot_b=self._robot_b,
+                # Conversations are two-sided, so the first two robots speak
+                robot_a=self._contexts[0].robot,
+                robot_b=self._contexts[1].robot,
             ))
 
-            # While the conversation is in progress
-            while not fut.done():
-                # Get the cancel state
-                cancel = None
-                if index == 1:
-                    cancel = self._cancel_a
-                elif index == 2:
-                    cancel = self._cancel_b
-
-                # Handle cancelling
-                if cancel:
-                    self._tprint('Conversation cancelling')
-
-                    # Reset the cancel state
-                    if index == 1:
-                        self._cancel_a = False
-                    elif index == 2:
-                        self._cancel_b = False
+            # Arrange to wake up if a cancel request comes in
+            cancel_wait = asyncio.ensure_future(ctx.evt_cancel.wait())
 
-                    break
+            # Sleep until the conversation finishes or a cancel arrives
+            await asyncio.wait([fut, cancel_wait], return_when=asyncio.FIRST_COMPLETED)
 
-                # Yield control
-                await asyncio.sleep(0)
+            # Handle cancelling
+            if self._check_cancel(ctx.index):
+                self._tprint('Conversation cancelling')
+
+            # Tidy up the cancel watch
+            cancel_wait.cancel()
 
             # Cancel the future
             # This forces a hard stop on the conversation
             fut.cancel()
 
-    async def _do_freeplay(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_freeplay(self, ctx: _RobotContext):
         """
-        Action for carrying out a conversation.
+        Action for carrying out freeplay.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
+        # The robot instance
+        robot = ctx.robot
 
-        self._tprint(f'Robot {letter} is engaging in freeplay')
+        self._tprint(f'Robot {ctx.letter} is engaging in freeplay')
 
         # Start freeplay mode
         robot.start_freeplay_behaviors()
 
-        # Sleep during freeplay
-        while True:
-            # Get the cancel state
-            cancel = None
-            if index == 1:
-                cancel = self._cancel_a
-            elif index == 2:
-                cancel = self._cancel_b
+        # Sleep during freeplay until a cancel request arrives
+        await ctx.evt_cancel.wait()
 
-            # Handle cancelling
-            if cancel:
-                self._tprint('Freeplay cancelling')
-
-                # Reset the cancel state
-                if index == 1:
-                    self._cancel_a = False
-                elif index == 2:
-                    self._cancel_b = False
-
-                break
-
-            # Yield control
-            await asyncio.sleep(0)
+        # Consume the cancel request
+        self._check_cancel(ctx.index)
+        self._tprint('Freeplay cancelling')
 
         # Stop freeplay mode
         robot.stop_freeplay_behaviors()
@@ -1150,18 +1475,17 @@ class OperationInteract(Operation):
         # Play happy animation
         await robot.play_anim_trigger(cozmo.anim.Triggers.DriveEndHappy).wait_for_completed()
 
-    async def _do_pong(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_pong(self, ctx: _RobotContext):
         """
         Action for playing pong.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'b'
+        # The robot instance
+        robot = ctx.robot
 
-        self._tprint(f'Robot {letter} is engaging in pong')
+        self._tprint(f'Robot {ctx.letter} is engaging in pong')
 
         # Look upward
         await robot.set_head_angle(cozmo.util.degrees(45)).wait_for_completed()
@@ -1183,25 +1507,16 @@ class OperationInteract(Operation):
         # Hear ye
         await robot.say_text("I'm bored, I will play some pong").wait_for_completed()
 
+        # The double-buffered face renderer
+        # Its buffers live for the whole game, so the loop below never allocates
+        renderer = _PongRenderer()
+
         # While the game is not over
         while not over:
-            # Get the cancel state
-            cancel = None
-            if index == 1:
-                cancel = self._cancel_a
-            elif index == 2:
-                cancel = self._cancel_b
-
             # Handle cancelling
-            if cancel:
+            # The event check is cheap, so the game loop stays at cadence
+            if self._check_cancel(ctx.index):
                 self._tprint('Pong cancelling')
-
-                # Reset the cancel state
-                if index == 1:
-                    self._cancel_a = False
-                elif index == 2:
-                    self._cancel_b = False
-
                 break
 
             # Update paddles based on ball position and velocity
@@ -1243,11 +1558,8 @@ class OperationInteract(Operation):
                 # The game is over, but we will still update the face
                 over = True
 
-            # Update the face image
-            face = self._pong_draw_face(0, 0, ball_x, ball_y, p1_x, p1_y, p2_x, p2_y)
-
-            # Convert face image to screen
-            screen = cozmo.oled_face.convert_image_to_screen_data(face)
+            # Compose the face image into screen data
+            screen = renderer.render(ball_x, ball_y, p1_x, p1_y, p2_x, p2_y)
 
             # Update Cozmo's face
             robot.display_oled_face_image(screen, 0.1)
@@ -1255,31 +1567,13 @@ class OperationInteract(Operation):
             # Sleep for a bit
             await asyncio.sleep(0.02)
 
-        # Set completion flag
-        self._complete = True
+        # Fire the completion event
+        self._evt_complete.set()
 
     def _pong_compute_paddle_y(self, ball_x, ball_y, ball_vel_x, ball_vel_y):
         # Set paddle height to ball height with a random slop for effect
         return ball_y + random.randint(-5, 5)
 
-    def _pong_draw_face(self, x, y, ball_x, ball_y, p2_x, p2_y, p1_x, p1_y):
-        # The new face image
-        face = Image.new('RGBA', (128, 64), (0, 0, 0, 255))
-
-        # Drawing context
-        draw = ImageDraw.Draw(face)
-
-        # Draw ball
-        draw.ellipse([ball_x - 5, ball_y - 5, ball_x + 5, ball_y + 5], fill=(255, 255, 255, 255))
-
-        # Draw paddle 1 (left)
-        draw.rectangle([p1_x + 3, p1_y - 10, p1_x, p1_y + 10], fill=(255, 255, 255, 255))
-
-        # Draw paddle 2 (right)
-        draw.rectangle([p2_x - 3, p2_y - 10, p2_x, p2_y + 10], fill=(255, 255, 255, 255))
-
-        return face
-
     def _pong_check_impact(self, ball_x, ball_y, ball_vel_x, ball_vel_y, paddle_y, robot):
         # If the ball hit the paddle (within y-tolerance)
         if abs(paddle_y - ball_y) < 10:
@@ -1297,83 +1591,48 @@ class OperationInteract(Operation):
 
         return ball_vel_x, ball_vel_y
 
-    async def _do_meet_and_greet(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_meet_and_greet(self, ctx: _RobotContext):
         """
-        Action for carrying out a conversation.
+        Action for carrying out meet and greet.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
-
-        self._tprint(f'Robot {letter} is engaging in greeting')
+        # The robot instance and its face service
+        robot = ctx.robot
+        service_face = ctx.service_face
 
-        # Get the robot-specific services
-        service_face = None
-        if index == 1:
-            service_face = self._service_face_a
-        elif index == 2:
-            service_face = self._service_face_b
+        self._tprint(f'Robot {ctx.letter} is engaging in greeting')
 
         # Tilt the head upward to look for faces
         await robot.set_head_angle(cozmo.robot.MAX_HEAD_ANGLE).wait_for_completed()
 
         broken = False
         while not self._almost_stopping and not broken:
-            self._tprint('Waiting to detect a face')
-
-            # Get the cancel state
-            cancel = None
-            if index == 1:
-                cancel = self._cancel_a
-            elif index == 2:
-                cancel = self._cancel_b
+            self._tprint('Waiting to detect a face', subsystem='greet')
 
             # Handle cancelling
-            if cancel:
+            if self._check_cancel(ctx.index):
                 self._tprint('Meet and greet cancelling')
-
-                # Reset the cancel state
-                if index == 1:
-                    self._cancel_a = False
-                elif index == 2:
-                    self._cancel_b = False
-
-                broken = True
                 break
 
             # Submit a work order to detect a face (on a background thread)
-            # Keeping it in concurrent future form will let us cancel it easily
-            face_det_future = service_face.next_track()
-
-            # While detection is not done
-            while not face_det_future.done():
-                # Get the cancel state
-                cancel = None
-                if index == 1:
-                    cancel = self._cancel_a
-                elif index == 2:
-                    cancel = self._cancel_b
-
-                # Handle cancelling
-                if cancel:
-                    self._tprint('Meet and greet cancelling')
-
-                    # Reset the cancel state
-                    if index == 1:
-                        self._cancel_a = False
-                    elif index == 2:
-                        self._cancel_b = False
-
-                    broken = True
-                    break
+            # The face service hands us a proper awaitable these days
+            face_det_future = asyncio.ensure_future(service_face.next_track())
+
+            # Arrange to wake up if a cancel request comes in
+            cancel_wait = asyncio.ensure_future(ctx.evt_cancel.wait())
 
-                # Yield control
-                await asyncio.sleep(0)
+            # Sleep until detection completes or a cancel arrives
+            await asyncio.wait([face_det_future, cancel_wait], return_when=asyncio.FIRST_COMPLETED)
 
-            if broken:
+            # Tidy up the cancel watch
+            cancel_wait.cancel()
+
+            # Handle cancelling
+            if self._check_cancel(ctx.index):
+                self._tprint('Meet and greet cancelling')
+                face_det_future.cancel()
                 break
 
             # The detected face
@@ -1388,7 +1647,7 @@ class OperationInteract(Operation):
             # This is a 4-tuple of the form (left, top, right, and bottom) with int components
             face_coords = face_det.coords
 
-            self._tprint(f'Detected face {face_index} at {face_coords}')
+            self._tprint(f'Detected face {face_index} at {face_coords}', subsystem='greet')
 
             # TODO: Center on the face
 
@@ -1397,7 +1656,12 @@ class OperationInteract(Operation):
             # FIXME: This might actually be bad, as the detection is more lenient than recognition
             #  The detector might pick up a motion-blurred face, but then recognition might be bad
             #  This is not a priority for the group presentation, however, as we can control how fast we turn
-            face_rec: RecognizedFace = await asyncio.wrap_future(service_face.recognize(face_index))
+            face_rec: RecognizedFace = await service_face.recognize(face_index)
+
+            # The track may have been pruned before recognition got to it
+            # There's nobody to greet, so go back to watching for faces
+            if face_rec is None:
+                continue
 
             # The face ID
             # This corresponds to the ID assigned to the matched face identity during program startup
@@ -1408,7 +1672,7 @@ class OperationInteract(Operation):
             # This is a 128-tuple of doubles for the face vector (AKA encoding, embedding, descriptor, etc.)
             face_ident = face_rec.ident
 
-            self._tprint(f'Recognized face {face_index} at {face_coords} as ID {face_id}')
+            self._tprint(f'Recognized face {face_index} at {face_coords} as ID {face_id}', subsystem='greet')
 
             if face_id == -1:
                 self._tprint('We do not know this face')
@@ -1432,27 +1696,33 @@ class OperationInteract(Operation):
                     await robot.say_text('I don\'t know you. Please type your name.').wait_for_completed()
 
                 # Wait for the prompt to come back
-                while True:
-                    with self._prompted_name_lock:
-                        if not self._prompted_name:
-                            name = self._prompted_name_response
-                            break
-                    await asyncio.sleep(0)
+                # The terminal interface fires this event when the name lands
+                await self._evt_prompted_name.wait()
+                self._evt_prompted_name.clear()
+                with self._prompted_name_lock:
+                    name = self._prompted_name_response
 
                 # Encode the identity to a string for storage in the database
                 face_ident_enc = self._face_ident_encode(face_ident)
 
-                # Insert face into the database and get the assigned face ID (thanks Herman, this is easy to use)
-                face_id = database.insertNewStudent(name, face_ident_enc)
+                # Queue the face for insertion and take a locally assigned face ID
+                # The write-behind journal commits it in the background, so we
+                # can greet right away instead of waiting on MySQL
+                # If the database never came up, the ID counter has no seed and
+                # there's no safe ID to hand out, so this face waits for later
+                try:
+                    face_id = database.insertNewStudentQueued(name, face_ident_enc)
+                except Exception as e:
+                    self._tprint(f'Cannot save a new face right now: {e}')
+                    continue
 
-                # The database update has completed
-                self._tprint('Database update completed')
+                # The database update has been queued
+                self._tprint('Database update queued')
 
-                # Add identity to both Cozmo A and B face services
-                # This lets us recognize this face again in the same session
+                # Add identity to the shared identity store
+                # This lets every Cozmo recognize this face again in the same session
                 # On subsequent sessions, we'll read from the database
-                self._service_face_a.add_identity(face_id, face_ident)
-                self._service_face_b.add_identity(face_id, face_ident)
+                self._face_identity_store.add_identity(face_id, face_ident)
 
                 # Repeat the name
                 num = random.randrange(3)
@@ -1466,10 +1736,27 @@ class OperationInteract(Operation):
                 self._tprint('We know this face')
 
                 # Get name and time last seen for this face
-                name, time_last_seen = database.determineStudent(face_id)
+                # This goes through the executor, so the drivers keep driving meanwhile
+                # The lookup can fail outright (database down) or come back
+                # empty (a queued insert the journal hasn't flushed yet), and
+                # neither is worth killing the driver over
+                try:
+                    student = await database.determineStudentAsync(face_id)
+                except Exception as e:
+                    self._tprint(f'Cannot look up this face right now: {e}')
+                    student = None
+
+                # Record the sighting in the write-behind journal
+                # The Date_seen update lands on the server at the next flush
+                database.recordSighting(face_id)
+
+                # Without a row there's no name or last-seen to use, so fall
+                # back to a generic welcome and go look for more faces
+                if student is None:
+                    await robot.say_text('Welcome back!').wait_for_completed()
+                    continue
 
-                # Update time last seen for face
-                database.checkForStudent(face_id)
+                name, time_last_seen = student
 
                 # Print time last seen
                 self._tprint(f'This face was last seen at {time_last_seen}')
@@ -1485,86 +1772,258 @@ class OperationInteract(Operation):
                 elif num == 2:
                     await robot.say_text(f'Good to see you, {name}!').wait_for_completed()
 
+    def _load_known_faces(self):
+        """
+        Bring the identity store in sync with the database.
+
+        This runs on its own thread, concurrently with the robot connection
+        dance, so time-to-first-greet is bounded by the robots rather than
+        the size of the student table. If the local snapshot already seeded
+        the store, only the delta against MySQL moves over the network; a
+        cold store streams the whole table in batches. Either way, each
+        batch of rows decodes into one N-by-128 float32 block and registers
+        in a single call, so the store takes one lock per batch.
+
+        If the database is unreachable, the store keeps whatever the
+        snapshot provided and the operation carries on.
+        """
+
+        # The face IDs the store already has (from the snapshot, usually)
+        known = self._face_identity_store.known_fids()
+
+        try:
+            if not known:
+                # Cold store: stream the whole table
+                loaded = 0
+                for rows in database.loadStudentsBatched():
+                    loaded += self._register_face_rows(rows)
+
+                self._tprint(f'Loaded {loaded} known face(s) from the database')
+            else:
+                # Warm store: diff the ID sets and move only the delta
+                db_ids = set(database.listStudentIDs() or [])
+
+                # Drop identities the database no longer has
+                for fid in known - db_ids:
+                    self._face_identity_store.remove_identity(fid)
+
+                # Fetch and register only the rows we're missing
+                added = 0
+                for rows in database.loadStudentsByIds(sorted(db_ids - known)):
+                    added += self._register_face_rows(rows)
+
+                self._tprint(f'Reconciled faces with the database '
+                             f'({added} added, {len(known - db_ids)} removed)')
+        except Exception as e:
+            self._tprint(f'Could not sync known faces with the database: {e}')
+            self._tprint('Continuing with the local snapshot contents')
+
+    def _register_face_rows(self, rows) -> int:
+        """
+        Decode one batch of student rows into the identity store.
+
+        Packed blobs decode as views, so this is mostly one block copy.
+
+        :param rows: A list of (face ID, encoded identity) rows
+        :return: The number of identities registered
+        """
+
+        fids = [fid for (fid, ident_enc) in rows]
+        idents = numpy.stack([self._face_ident_decode(ident_enc) for (fid, ident_enc) in rows]) \
+            .astype(numpy.float32)
+
+        # Register the batch with the shared identity store
+        # Every Cozmo recognizes out of this one copy
+        self._face_identity_store.add_identities(fids, idents)
+
+        return len(fids)
+
     @staticmethod
-    def _face_ident_decode(ident_enc: str) -> Tuple[float, ...]:
+    def _face_ident_decode(ident_enc) -> numpy.ndarray:
         """
-        Decode a string-encoded face identity.
+        Decode an encoded face identity.
+
+        Identities are stored as packed little-endian float32 blobs. Rows
+        written before the schema migration are still JSON text, and those
+        decode through the legacy path.
 
         :param ident_enc: The encoded identity
-        :return: The decoded identity
+        :return: The decoded identity (128-dim float32 vector)
         """
 
-        # Load the 128-tuple of floats from JSON
-        ident = json.loads(ident_enc)
+        # If the row predates the packed format, it's JSON text
+        if isinstance(ident_enc, str):
+            return numpy.asarray(json.loads(ident_enc), dtype=numpy.float32)
 
-        return ident
+        # View the packed blob as a float32 vector without a copy
+        return numpy.frombuffer(ident_enc, dtype='<f4')
 
     @staticmethod
-    def _face_ident_encode(ident: Tuple[float, ...]) -> str:
+    def _face_ident_encode(ident: Tuple[float, ...]) -> bytes:
         """
-        Encode a face identity to string.
+        Encode a face identity for storage in the database.
 
         :param ident: The decoded identity
-        :return: The encoded identity
+        :return: The identity as a packed little-endian float32 blob
         """
 
-        # Dump the 128-tuple of floats into JSON
-        ident_json = json.dumps(ident)
+        # Pack the 128 floats into a little-endian float32 blob
+        # This is ~512 bytes per face versus ~3 KB of JSON text
+        return numpy.asarray(ident, dtype='<f4').tobytes()
 
-        return ident_json
-
-    async def _do_return_to_waypoint(self, index: int, robot: cozmo.robot.Robot):
+    async def _do_return_to_waypoint(self, ctx: _RobotContext):
         """
         Action for returning to waypoint.
 
-        :param index: The robot index
-        :param robot: The robot instance
+        :param ctx: The robot context
         """
 
-        # Convert robot index to robot letter
-        letter = 'A' if index == 1 else 'B'
+        self._tprint(f'Robot {ctx.letter} is returning to waypoint')
 
-        self._tprint(f'Robot {letter} is returning to waypoint')
+        # Return to the saved waypoint (based on Eric's routine)
+        await ctx.robot.go_to_pose(ctx.waypoint).wait_for_completed()
 
-        # Get the robot waypoint
-        waypoint = None
-        if index == 1:
-            waypoint = self._robot_waypoint_a
-        elif index == 2:
-            waypoint = self._robot_waypoint_b
+    def start_recording(self, directory: str) -> bool:
+        """
+        Start recording camera frames for all connected robots.
 
-        # Return to the saved waypoint (based on Eric's routine)
-        await robot.go_to_pose(waypoint).wait_for_completed()
+        This is safe to call from any thread.
+
+        :param directory: The base recording directory
+        :return: True if recording started, otherwise False
+        """
+
+        # Refuse to double up on recorders
+        if any(ctx.recorder is not None for ctx in self._contexts):
+            return False
+
+        for ctx in self._contexts:
+            # Skip slots without a connected robot
+            if ctx.robot is None:
+                continue
+
+            # Spin up a recorder for this robot
+            # The camera callback picks it up on the next frame
+            recorder = FrameRecorder(directory, ctx.letter)
+            recorder.start()
+            ctx.recorder = recorder
+
+        return True
+
+    def stop_recording(self) -> bool:
+        """
+        Stop recording camera frames.
+
+        This is safe to call from any thread.
+
+        :return: True if a recording was stopped, otherwise False
+        """
+
+        stopped = False
+
+        for ctx in self._contexts:
+            recorder = ctx.recorder
+
+            if recorder is not None:
+                # Detach first so the camera callback stops feeding it,
+                # then flush whatever is still in the ring
+                ctx.recorder = None
+                recorder.stop()
+                stopped = True
+
+        return stopped
+
+    def set_stats_interval(self, interval: float):
+        """
+        Set the periodic stats line interval.
+
+        This is safe to call from any thread.
+
+        :param interval: The interval in seconds, or None/0 to turn it off
+        """
+
+        self._stats_interval = interval if interval else None
+
+    async def _stats_reporter(self):
+        """
+        Periodically print a one-line stats summary when enabled.
+        """
+
+        while not self._almost_stopping:
+            # Sleep for one reporting interval (or until shutdown)
+            # When reporting is off we still wake occasionally to re-check
+            try:
+                await asyncio.wait_for(self._evt_should_stop.wait(), timeout=self._stats_interval or 5.0)
+            except asyncio.TimeoutError:
+                pass
+            else:
+                break
+
+            # Print the line if reporting is on
+            if self._stats_interval is not None:
+                self._tprint(instrumentation.summary_line())
+
+    def _schedule_next_activity(self):
+        """
+        Sample the kind and time of the next choreographed activity.
+
+        The delay comes from an exponential draw with a 90-minute mean, so
+        activities arrive at the same average rate as before, but the timing
+        no longer depends on how fast the choreographer loop ticks.
+        """
+
+        self._next_activity = random.choice(['convo', 'pong', 'freeplay'])
+        self._next_activity_time = time.monotonic() + random.expovariate(1 / _activity_mean_interval)
+
+    def get_schedule(self) -> Tuple[str, float]:
+        """
+        Get the upcoming activity schedule.
+
+        This is safe to call from any thread.
+
+        :return: The next activity name and the seconds until it starts, or
+                 (None, None) if nothing is scheduled yet
+        """
+
+        if self._next_activity is None:
+            return None, None
+
+        return self._next_activity, self._next_activity_time - time.monotonic()
 
     async def _choreographer(self):
         """
-        The choreographer gives high-level commands to one or two robots.
+        The choreographer gives high-level commands to the robot fleet.
 
         Following the algorithm designed by David.
         """
 
         self._tprint('Choreographer has started')
 
-        # The Cozmo choice
+        # The chosen Cozmo's index
+        # The fleet takes turns: the next robot in line steps up whenever the
+        # current one's battery runs down
         choice = 1
 
         # The idle flag
         idle = False
 
-        # The current chosen queue
-        queue_choice = None
+        # Whether the swap already sent the chosen robot out
+        predispatched = False
+
+        # Sample the first scheduled activity
+        self._schedule_next_activity()
 
         while not self._almost_stopping:
             # Get the queue for the chosen robot
-            if choice == 1:  # Chosen A
-                queue_choice = self._robot_queue_a
-            elif choice == 2:  # Chosen B
-                queue_choice = self._robot_queue_b
+            queue_choice = self._context(choice).queue
 
-            queue_choice.put(_RobotState.waypoint)
-            queue_choice.put(_RobotState.greet)
+            # Send the robot out unless the swap already dispatched it
+            if not predispatched:
+                queue_choice.put(_RobotState.waypoint)
+                queue_choice.put(_RobotState.greet)
+            predispatched = False
 
-            while self._is_battery_good(choice):
+            while self._is_battery_good(choice) and not self._swap_is_due(choice):
                 # This is an override point
                 if await self._wait_while_overridden():
                     continue
@@ -1575,20 +2034,33 @@ class OperationInteract(Operation):
                     queue_choice.put(_RobotState.greet)
                     idle = False
 
-                # Pick a random activity
-                rand_activity = random.randrange(1, 162000)  # Something every 90 minutes on average
+                # If the scheduled time hasn't arrived yet
+                remaining = self._next_activity_time - time.monotonic()
+                if remaining > 0:
+                    # Sleep toward the scheduled time
+                    # The wakeup bound keeps the battery reading fresh, and a
+                    # shutdown request cuts the sleep short immediately
+                    try:
+                        await asyncio.wait_for(self._evt_should_stop.wait(),
+                                               timeout=min(remaining, _choreographer_wakeup_interval))
+                    except asyncio.TimeoutError:
+                        continue
+
+                    # The stop event fired
+                    break
+
+                # Take the scheduled activity and immediately sample the next
+                rand_activity = self._next_activity
+                self._schedule_next_activity()
 
-                if rand_activity == 1:
+                if rand_activity == 'convo':
                     self._tprint('Going to do conversation')
 
                     # Cancel greeting
-                    if choice == 1:  # Chosen A
-                        self._cancel_a = True
-                    elif choice == 2:  # Chosen B
-                        self._cancel_b = True
+                    self._cancel_event(choice).set()
 
-                    # Clear complete flag
-                    self._complete = False
+                    # Clear complete event
+                    self._evt_complete.clear()
 
                     queue_choice.put(_RobotState.waypoint)
                     queue_choice.put(_RobotState.convo)
@@ -1600,9 +2072,7 @@ class OperationInteract(Operation):
                     queue_choice.put(convo_name)
 
                     # While conversation is running
-                    while not self._almost_stopping and self._is_battery_good(choice) and not self._complete:
-                        # Yield control
-                        await asyncio.sleep(0)
+                    await self._wait_activity_complete(choice)
 
                     # Set idle flag
                     idle = True
@@ -1612,25 +2082,20 @@ class OperationInteract(Operation):
                         continue
 
                     self._tprint('Choreographer detected conversation complete')
-                elif rand_activity == 2:
+                elif rand_activity == 'pong':
                     self._tprint('Going to do pong')
 
                     # Cancel greeting
-                    if choice == 1:  # Chosen A
-                        self._cancel_a = True
-                    elif choice == 2:  # Chosen B
-                        self._cancel_b = True
+                    self._cancel_event(choice).set()
 
-                    # Clear complete flag
-                    self._complete = False
+                    # Clear complete event
+                    self._evt_complete.clear()
 
                     queue_choice.put(_RobotState.waypoint)
                     queue_choice.put(_RobotState.pong)
 
                     # While pong is running
-                    while not self._almost_stopping and self._is_battery_good(choice) and not self._complete:
-                        # Yield control
-                        await asyncio.sleep(0)
+                    await self._wait_activity_complete(choice)
 
                     # Set idle flag
                     idle = True
@@ -1640,35 +2105,27 @@ class OperationInteract(Operation):
                         continue
 
                     self._tprint('Choreographer detected pong complete')
-                elif rand_activity == 3:
+                elif rand_activity == 'freeplay':
                     self._tprint('Going to do freeplay')
 
                     # Cancel greeting
-                    if choice == 1:  # Chosen A
-                        self._cancel_a = True
-                    elif choice == 2:  # Chosen B
-                        self._cancel_b = True
+                    self._cancel_event(choice).set()
 
-                    # Clear complete flag
-                    self._complete = False
+                    # Clear complete event
+                    self._evt_complete.clear()
 
                     queue_choice.put(_RobotState.waypoint)
                     queue_choice.put(_RobotState.freeplay)
 
                     # While the freeplay mode is running
-                    start = time.clock()
-                    while not self._almost_stopping and self._is_battery_good(choice):
-                        if time.clock() - start > 20:  # Only stay in freeplay for twenty seconds
-                            break
-
-                        # Yield control
-                        await asyncio.sleep(0)
+                    # Only stay in freeplay for twenty seconds (or until shutdown)
+                    try:
+                        await asyncio.wait_for(self._evt_should_stop.wait(), timeout=20)
+                    except asyncio.TimeoutError:
+                        pass
 
                     # Cancel freeplay
-                    if choice == 1:  # Chosen A
-                        self._cancel_a = True
-                    elif choice == 2:  # Chosen B
-                        self._cancel_b = True
+                    self._cancel_event(choice).set()
 
                     # Set idle flag
                     idle = True
@@ -1676,43 +2133,47 @@ class OperationInteract(Operation):
                     # This is an override point
                     await self._wait_while_overridden()
 
-                # Clear the completion flag
-                self._complete = False
+                # Clear the completion event
+                self._evt_complete.clear()
+
+            # The next Cozmo in line
+            next_choice = choice % len(self._contexts) + 1
 
-                # Sleep for a fixed time
-                await asyncio.sleep(0.1)  # Choreographer loops once every tenth of a second
+            # Say why the swap is starting
+            remaining = self._battery_seconds_to_flat(choice)
+            if remaining is not None and self._is_battery_good(choice):
+                self._tprint(f'Robot {self._context(choice).letter} is predicted to go flat '
+                             f'in {remaining / 60:.1f} minutes, so swapping proactively')
 
             # Cancel greeting
-            if choice == 1:  # Chosen A
-                self._cancel_a = True
-            elif choice == 2:  # Chosen B
-                self._cancel_b = True
+            self._cancel_event(choice).set()
 
-            # Clear complete flag
-            self._complete = False
+            # Clear complete event
+            self._evt_complete.clear()
 
             queue_choice.put(_RobotState.waypoint)
             queue_choice.put(_RobotState.home)
 
+            # Send the incoming robot out while the outgoing one returns
+            # Overlapping the two transits keeps the greeting post manned
+            # (with a single robot there's nobody to overlap with)
+            if next_choice != choice:
+                queue_next = self._context(next_choice).queue
+                queue_next.put(_RobotState.waypoint)
+                queue_next.put(_RobotState.greet)
+                predispatched = True
+
             # While driving to home
-            while not self._almost_stopping and self._is_battery_good(choice) and not self._complete:
-                # Yield control
-                await asyncio.sleep(0)
+            # Only the homeward robot fires the completion event
+            await self._wait_activity_complete(choice, ignore_battery=True)
 
             self._tprint('Choreographer detected driven to home')
 
-            # Swap the Cozmos
-            if choice == 1:
-                choice = 2
-            elif choice == 2:
-                choice = 1
+            # Rotate to the next Cozmo in the fleet
+            choice = next_choice
 
         # Get the queue for the chosen robot
-        queue_choice = None
-        if choice == 1:  # Chosen A
-            queue_choice = self._robot_queue_a
-        elif choice == 2:  # Chosen B
-            queue_choice = self._robot_queue_b
+        queue_choice = self._context(choice).queue
 
         queue_choice.put(_RobotState.waypoint)
         queue_choice.put(_RobotState.home)
@@ -1722,6 +2183,26 @@ class OperationInteract(Operation):
         # Now we can tear down the low-level loops
         self._stopping = True
 
+    async def _wait_activity_complete(self, index: int, ignore_battery: bool = False):
+        """
+        Wait until the current activity fires the completion event.
+
+        The event loop sleeps between wakeups, but we still come up for air
+        once a second to check the battery and the shutdown indicator.
+
+        :param index: The robot index
+        :param ignore_battery: Whether to keep waiting on a low battery
+        """
+
+        while not self._almost_stopping and (ignore_battery or self._is_battery_good(index)):
+            try:
+                # Sleep until completion (or the periodic battery check)
+                await asyncio.wait_for(self._evt_complete.wait(), timeout=1)
+            except asyncio.TimeoutError:
+                continue
+
+            break
+
     def _is_battery_good(self, index: int):
         """
         Test if the battery on a robot is good.
@@ -1731,14 +2212,96 @@ class OperationInteract(Operation):
         """
 
         # Get the battery potential
-        potential = 0
-        if index == 1:
-            potential = self._robot_a.battery_voltage
-        elif index == 2:
-            potential = self._robot_b.battery_voltage
+        potential = self._context(index).robot.battery_voltage
 
         # If the battery is good...
-        return potential > 3.5
+        return potential > _battery_low_voltage
+
+    async def _battery_monitor(self):
+        """
+        Periodically sample battery voltage into each robot's history.
+
+        The choreographer fits a discharge trend over this history, so a
+        swap can start while the outgoing robot still has margin instead of
+        waiting until it's already nearly flat.
+        """
+
+        while not self._almost_stopping:
+            # Sleep one sample interval (or until shutdown)
+            try:
+                await asyncio.wait_for(self._evt_should_stop.wait(), timeout=_battery_sample_interval)
+            except asyncio.TimeoutError:
+                pass
+            else:
+                break
+
+            now = time.monotonic()
+
+            for ctx in self._contexts:
+                # Skip slots without a connected robot
+                if ctx.robot is None:
+                    continue
+
+                # A robot on its charger is charging, not discharging, so its
+                # old trend is meaningless once it next drives off
+                if ctx.robot.is_on_charger:
+                    ctx.battery_history.clear()
+                    continue
+
+                ctx.battery_history.append((now, ctx.robot.battery_voltage))
+
+    def _battery_seconds_to_flat(self, index: int):
+        """
+        Predict the seconds until a robot's battery hits the low threshold.
+
+        This fits a least-squares line through the recent voltage history
+        and extrapolates it to the threshold. Cozmo's discharge curve isn't
+        truly linear, but over the fifteen-minute window it's close enough
+        to schedule a swap with margin.
+
+        :param index: The robot index
+        :return: The predicted seconds, or None if there's no usable trend
+        """
+
+        history = list(self._context(index).battery_history)
+
+        # Not enough samples to trust a fit yet
+        if len(history) < _battery_trend_min_samples:
+            return None
+
+        # Fit volts = slope * time + intercept by least squares
+        t0 = history[0][0]
+        xs = [t - t0 for (t, v) in history]
+        ys = [v for (t, v) in history]
+        n = len(history)
+        mean_x = sum(xs) / n
+        mean_y = sum(ys) / n
+        var_x = sum((x - mean_x) ** 2 for x in xs)
+
+        # A flat time axis can't carry a slope
+        if var_x == 0:
+            return None
+
+        slope = sum((x - mean_x) * (y - mean_y) for x, y in zip(xs, ys)) / var_x
+
+        # A non-negative slope means we're not discharging (yet)
+        if slope >= 0:
+            return None
+
+        # Extrapolate from the latest sample down to the threshold
+        return max((_battery_low_voltage - ys[-1]) / slope, 0.0)
+
+    def _swap_is_due(self, index: int):
+        """
+        Test if a robot's predicted flat time is inside the swap margin.
+
+        :param index: The robot index
+        :return: True if the swap should start now, otherwise False
+        """
+
+        remaining = self._battery_seconds_to_flat(index)
+
+        return remaining is not None and remaining <= _battery_swap_margin
 
     async def _wait_while_overridden(self):
         """
@@ -1760,26 +2323,45 @@ class OperationInteract(Operation):
 
             was_overridden = True
 
-            # Enter a loop until it is disabled
+            # Sleep until the flag toggles back off
+            # The terminal interface fires the changed event on every toggle
             while True:
+                await self._evt_override_changed.wait()
+                self._evt_override_changed.clear()
+
                 with self._override_lock:
                     if not self._override:
                         break
 
-                # Yield control
-                await asyncio.sleep(0)
-
         return was_overridden
 
-    def _tprint(self, text: str):
+    def _tprint(self, text: str, subsystem: str = 'interact'):
         """
         Terminal print.
 
-        This is kinda like print(), but it doesn't trample our terminal prompt.
+        This is kinda like print(), but it doesn't trample our terminal
+        prompt. Lines land in a per-thread ring and the background log
+        writer batches them to the terminal, so hot paths never contend on
+        the terminal lock.
 
         :param text: The text to print
+        :param subsystem: The subsystem tag (for verbosity control)
+        """
+
+        termlog.emit(subsystem, text)
+
+    def _term_alert(self, lines: list):
+        """
+        Deliver one batch of log lines to the terminal.
+
+        This runs on the log writer thread, once per flush interval, so the
+        terminal lock is taken once per batch instead of once per line.
+
+        :param lines: The lines to deliver
         """
 
+        text = '\n'.join(lines)
+
         # Just print if terminal interface unavailable
         if self._term is None:
             print(text)
@@ -1834,22 +2416,26 @@ class InteractInterface(cmd2.Cmd):
         """Change the selected Cozmo for future commands."""
 
         # Get the requested robot index
-        self._selected_robot = self._robot_char_to_index(args.robot)
+        index = self._robot_char_to_index(args.robot)
 
-        if self._selected_robot == 1:
-            print('Selected robot A')
-        elif self._selected_robot == 2:
-            print('Selected robot B')
+        # noinspection PyProtectedMember
+        ctx = self._op._context(index)
+
+        if ctx is not None:
+            self._selected_robot = index
+            print(f'Selected robot {ctx.letter}')
         else:
+            self._selected_robot = None
             print('Deselected robot')
 
     def do_selected(self, args):
         """Query the selected robot."""
 
-        if self._selected_robot == 1:
-            print('Robot A is selected')
-        elif self._selected_robot == 2:
-            print('Robot B is selected')
+        # noinspection PyProtectedMember
+        ctx = self._op._context(self._selected_robot) if self._selected_robot is not None else None
+
+        if ctx is not None:
+            print(f'Robot {ctx.letter} is selected')
         else:
             print('No robot selected')
 
@@ -1863,20 +2449,110 @@ class InteractInterface(cmd2.Cmd):
         # Get the requested robot index
         index = self._robot_char_to_index(args.robot)
 
-        # Get the robot state
-        state = None
-        if index == 1:  # Robot A
-            # noinspection PyProtectedMember
-            state = self._op._robot_state_a
-        elif index == 2:  # Robot B
-            # noinspection PyProtectedMember
-            state = self._op._robot_state_b
-        else:
+        # Get the robot context
+        # noinspection PyProtectedMember
+        ctx = self._op._context(index)
+
+        if ctx is None:
             print(f'Invalid robot: "{args.robot}"')
+            return
 
         # Print name and number of state
-        if state is not None:
-            print(f'{state.value}: "{state.name}"')
+        if ctx.state is not None:
+            print(f'{ctx.state.value}: "{ctx.state.name}"')
+
+    stats_parser = argparse.ArgumentParser()
+    stats_parser.add_argument('-w', '--watch', type=float, default=None,
+                              help='print a summary line every N seconds (0 turns it off)')
+    stats_parser.add_argument('-r', '--reset', action='store_true', help='reset the recorded statistics')
+
+    @cmd2.with_argparser(stats_parser)
+    def do_stats(self, args):
+        """Show pipeline performance statistics."""
+
+        # Handle resetting
+        if args.reset:
+            instrumentation.reset()
+            print('Statistics reset')
+            return
+
+        # Handle toggling the periodic line
+        if args.watch is not None:
+            self._op.set_stats_interval(args.watch)
+
+            if args.watch:
+                print(f'Printing a stats line every {args.watch} seconds')
+            else:
+                print('Periodic stats line turned off')
+            return
+
+        # Print the full report
+        print(instrumentation.report())
+
+    log_parser = argparse.ArgumentParser()
+    log_parser.add_argument('subsystem', type=str, nargs='?', default=None,
+                            help='the subsystem to control (omit to list them)')
+    log_parser.add_argument('state', type=str, nargs='?', default=None, choices=[None, 'on', 'off'],
+                            help='turn the subsystem on or off')
+
+    @cmd2.with_argparser(log_parser)
+    def do_log(self, args):
+        """Control per-subsystem log verbosity."""
+
+        # With no subsystem, list them all
+        if args.subsystem is None:
+            names = termlog.subsystems()
+
+            if not names:
+                print('No subsystems have logged yet')
+                return
+
+            for name in names:
+                print(f'{name}: {"on" if termlog.verbosity(name) else "off"}')
+            return
+
+        # With no state, show the one subsystem
+        if args.state is None:
+            print(f'{args.subsystem}: {"on" if termlog.verbosity(args.subsystem) else "off"}')
+            return
+
+        # Flip the switch
+        termlog.set_verbosity(args.subsystem, args.state == 'on')
+        print(f'Log subsystem "{args.subsystem}" is now {args.state}')
+
+    record_parser = argparse.ArgumentParser()
+    record_parser.add_argument('-d', '--directory', type=str, default='recordings',
+                               help='the base recording directory')
+    record_parser.add_argument('--off', action='store_true', help='stop recording')
+
+    @cmd2.with_argparser(record_parser)
+    def do_record(self, args):
+        """Record camera frames to disk for offline replay."""
+
+        # Handle stopping
+        if args.off:
+            if self._op.stop_recording():
+                print('Recording stopped')
+            else:
+                print('No recording is running')
+            return
+
+        # Start recording on all connected robots
+        if self._op.start_recording(args.directory):
+            print(f'Recording camera frames under "{args.directory}"')
+        else:
+            print('A recording is already running')
+
+    def do_schedule(self, args):
+        """Query the upcoming activity schedule."""
+
+        # Ask the operation for the schedule
+        activity, remaining = self._op.get_schedule()
+
+        if activity is None:
+            print('No activity is scheduled (is the choreographer running?)')
+        else:
+            print(f'Next activity is "{activity}" in {remaining / 60:.1f} minutes')
 
     def do_cancel(self, args):
         """Cancel the activity on the selected Cozmo robot."""
@@ -1888,13 +2564,9 @@ class InteractInterface(cmd2.Cmd):
 
         print('Cancelling the activity')
 
-        # Set the appropriate cancel flag
-        if self._selected_robot == 1:  # Robot A
-            # noinspection PyProtectedMember
-            self._op._cancel_a = True
-        elif self._selected_robot == 2:  # Robot B
-            # noinspection PyProtectedMember
-            self._op._cancel_b = True
+        # Request cancellation on the selected robot
+        # This fires the cancel event over on the interact loop
+        self._op.request_cancel(self._selected_robot)
 
     def do_waypoint(self, args):
         """Drive the selected Cozmo to its waypoint."""
@@ -1999,6 +2671,9 @@ class InteractInterface(cmd2.Cmd):
         with self._op._override_lock:
             self._op._override = not self._op._override
 
+        # Wake up anything waiting on the override flag
+        self._op.notify_override_changed()
+
     def precmd(self, statement: cmd2.Statement) -> cmd2.Statement:
         # noinspection PyProtectedMember
         with self._op._prompted_name_lock:
@@ -2009,6 +2684,9 @@ class InteractInterface(cmd2.Cmd):
                 self._op._prompted_name = False
                 self._op._prompted_name_response = str(statement.raw)
 
+                # Wake up the coroutine waiting on the name
+                self._op.notify_prompted_name()
+
                 # Restore the prompt
                 self.prompt = '(cozmo) '
 
@@ -2020,28 +2698,30 @@ class InteractInterface(cmd2.Cmd):
     def _get_robot_state_queue(self):
         """Get the state queue for the selected robot."""
 
-        if self._selected_robot == 1:
-            # noinspection PyProtectedMember
-            return self._op._robot_queue_a
-        elif self._selected_robot == 2:
-            # noinspection PyProtectedMember
-            return self._op._robot_queue_b
+        # noinspection PyProtectedMember
+        ctx = self._op._context(self._selected_robot) if self._selected_robot is not None else None
+
+        if ctx is not None:
+            return ctx.queue
 
     @staticmethod
     def _robot_char_to_index(char: any) -> int:
         """
         Convert a robot character (e.g. 'a', 'B', '1', etc.) to its index.
 
-        On error, this function returns zero.
+        This works for any fleet size: letters map alphabetically and digits
+        map directly. On error, this function returns zero.
 
         :param char: The robot character
         :return: The robot index
         """
 
-        if char == 'a' or char == 'A' or char == '1':
-            return 1
-        elif char == 'b' or char == 'B' or char == '2':
-            return 2
+        text = str(char)
+
+        if len(text) == 1 and text.isalpha():
+            return ord(text.lower()) - ord('a') + 1
+        elif text.isdigit():
+            return int(text)
         else:
             return 0
 
@@ -0,0 +1,192 @@
+#
+# Cozmonaut
+# Copyright 2019 The Cozmonaut Contributors
+#
+
+import asyncio
+import os
+import resource
+import time
+
+import PIL.Image
+import numpy
+
+from cozmonaut.operation.interact import instrumentation
+from cozmonaut.operation.interact.service.face import FaceIdentityStore, ServiceFace
+
+
+def _load_frames(frames_dir: str):
+    """
+    Load a recorded directory of camera frames into memory.
+
+    Frames replay in sorted filename order, so a recording with timestamped
+    names plays back in the order it was captured.
+
+    :param frames_dir: The directory of frame images
+    :return: A list of PIL images
+    """
+
+    frames = []
+
+    for name in sorted(os.listdir(frames_dir)):
+        path = os.path.join(frames_dir, name)
+
+        if not os.path.isfile(path):
+            continue
+
+        try:
+            with PIL.Image.open(path) as image:
+                # Decode now; replay should not pay disk or decode time
+                frames.append(image.convert('RGB'))
+        except OSError:
+            # Not an image (a stray readme, perhaps); skip it
+            continue
+
+    return frames
+
+
+def _seed_identities(store: FaceIdentityStore, count: int):
+    """
+    Seed an identity store with synthetic identities.
+
+    The draw is seeded, so two benchmark runs search the same store.
+
+    :param store: The identity store to fill
+    :param count: The number of identities to add
+    """
+
+    if count <= 0:
+        return
+
+    rng = numpy.random.RandomState(42)
+
+    # Face embeddings live roughly on a shell of small-magnitude vectors, so
+    # a narrow normal draw makes a plausible stand-in population
+    idents = rng.normal(0, 0.1, (count, 128)).astype(numpy.float32)
+
+    store.add_identities(list(range(1, count + 1)), idents)
+
+
+async def _consume_tracks(service: ServiceFace):
+    """
+    Continuously consume new tracks and recognize them.
+
+    This stands in for the meet-and-greet loop, keeping the detection and
+    recognition stages under load for the whole replay.
+
+    :param service: The face service under test
+    """
+
+    while True:
+        # Wait for the next new track
+        face = await service.next_track()
+
+        # Recognize it, just like greeting would
+        await service.recognize(face.index)
+
+
+async def _replay(service: ServiceFace, frames: list, fps: float, loops: int):
+    """
+    Replay frames through the face service at a fixed rate.
+
+    :param service: The face service under test
+    :param frames: The frames to replay
+    :param fps: The replay rate in frames per second
+    :param loops: How many times to replay the frame set
+    :return: A (frame count, elapsed seconds) pair
+    """
+
+    interval = 1.0 / fps
+
+    # Keep the back half of the pipeline busy
+    tracker_task = asyncio.ensure_future(_consume_tracks(service))
+
+    started = time.perf_counter()
+    count = 0
+
+    for _ in range(loops):
+        for frame in frames:
+            # Feed the frame just like the camera callback does
+            service.update(frame)
+            count += 1
+
+            # Pace the replay against the start time
+            # Pacing off the schedule (not the last frame) avoids drift
+            delay = started + count * interval - time.perf_counter()
+            if delay > 0:
+                await asyncio.sleep(delay)
+
+    elapsed = time.perf_counter() - started
+
+    # Let in-flight detection and recognition settle before reporting
+    await asyncio.sleep(1.0)
+
+    # Reel the consumer in before the loop closes
+    # Cancelling without awaiting would leave the task pending and spray a
+    # "Task was destroyed" warning over the report
+    tracker_task.cancel()
+    try:
+        await tracker_task
+    except asyncio.CancelledError:
+        pass
+
+    return count, elapsed
+
+
+def run(frames_dir: str, fps: float = 15.0, identities: int = 1000, loops: int = 1):
+    """
+    Run the face pipeline benchmark.
+
+    This replays recorded frames through ServiceFace at a configurable rate
+    against a synthetic identity store, then prints the instrumentation
+    report (detection latency percentiles, counters) along with throughput
+    and peak RSS.
+
+    :param frames_dir: The directory of recorded camera frames
+    :param fps: The replay rate in frames per second
+    :param identities: The number of synthetic identities to seed
+    :param loops: How many times to replay the frame set
+    """
+
+    print(f'Loading frames from {frames_dir}')
+
+    # Load the recording up front
+    frames = _load_frames(frames_dir)
+
+    if not frames:
+        print('No frames found, so nothing to benchmark')
+        return
+
+    print(f'Loaded {len(frames)} frames')
+    print(f'Seeding identity store with {identities} synthetic identities')
+
+    # Build the store and the service under test
+    store = FaceIdentityStore()
+    _seed_identities(store, identities)
+    service = ServiceFace(store)
+
+    # Start from a clean slate so the report covers only this run
+    instrumentation.reset()
+
+    print(f'Replaying at {fps} fps ({loops} loop(s))')
+
+    # Replay on a private event loop, like the interact thread would
+    loop = asyncio.new_event_loop()
+    asyncio.set_event_loop(loop)
+
+    service.start()
+    try:
+        count, elapsed = loop.run_until_complete(_replay(service, frames, fps, loops))
+    finally:
+        service.stop()
+        loop.close()
+
+    # Peak RSS (ru_maxrss is in kilobytes on Linux)
+    peak_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+    print()
+    print(instrumentation.report())
+    print()
+    print(f'frames replayed: {count} in {elapsed:.1f} s ({count / elapsed:.1f} fps effective)')
+    print(f'frames dropped by ring: {service.frames_dropped}')
+    print(f'peak rss: {peak_rss / 1024:.1f} MB')
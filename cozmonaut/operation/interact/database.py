@@ -3,121 +3,531 @@
 # Copyright 2019 The Cozmonaut Contributors
 #
 
-import mysql.connector
+import asyncio
+import queue
+import time
+from concurrent.futures.thread import ThreadPoolExecutor
 from datetime import datetime
+from threading import Event, Lock, Thread
+
+import mysql.connector
+import mysql.connector.pooling
+
+from cozmonaut.operation.interact import instrumentation
+
+# Connection parameters for the SQL server
+_config = {
+    'host': 'localhost',
+    'user': 'root',
+    'passwd': 'password',
+    'database': 'Cozmo',
+}
+
+# The connection pool
+# This is created lazily on first use, so importing this module is free
+_pool: mysql.connector.pooling.MySQLConnectionPool = None
+_pool_lock = Lock()
+_pool_size = 4
+
+# The executor for async calls
+# This keeps blocking MySQL round-trips off the asyncio event loop thread
+_executor = ThreadPoolExecutor(max_workers=_pool_size, thread_name_prefix='database')
+
+# Retry policy for dropped connections
+_retry_attempts = 3
+_retry_delay = 0.5  # Seconds between attempts
+
+# The write-behind journal
+# Sightings and new-student inserts are appended here immediately and a
+# background flusher batches them to MySQL, so the greet flow never waits on
+# a commit
+_journal = queue.Queue()
+_journal_thread: Thread = None
+_journal_stop = Event()
+_journal_flush_interval = 1.0  # Seconds between flushes
+
+# The next student ID to hand out locally
+# This is seeded from the database when the journal starts, and inserts carry
+# their assigned IDs explicitly so the server agrees with us
+_next_student_id = None
+_next_student_id_lock = Lock()
+
+
+def _get_pool() -> mysql.connector.pooling.MySQLConnectionPool:
+    """
+    Get the connection pool, creating it on first use.
+
+    :return: The connection pool
+    """
+
+    global _pool
+
+    with _pool_lock:
+        # Create the pool if it doesn't exist yet
+        if _pool is None:
+            _pool = mysql.connector.pooling.MySQLConnectionPool(
+                pool_name='cozmonaut',
+                pool_size=_pool_size,
+                **_config,
+            )
+
+        return _pool
+
+
+def _run(statement: str, params: tuple = (), commit: bool = False, fetch: bool = False):
+    """
+    Run one prepared statement on a pooled connection.
+
+    Dropped connections are retried a few times before giving up, so a
+    momentary database hiccup doesn't take down the whole operation.
+
+    :param statement: The SQL statement with %s placeholders
+    :param params: The statement parameters
+    :param commit: Whether to commit afterward
+    :param fetch: Whether to fetch and return all result rows
+    :return: The result rows if fetch is requested, otherwise the last row ID
+    """
+
+    # The last error seen (re-raised if all attempts fail)
+    last_error = None
+
+    for attempt in range(_retry_attempts):
+        # Back off a little between attempts
+        if attempt > 0:
+            time.sleep(_retry_delay)
+
+        try:
+            # Borrow a connection from the pool
+            # Returning it is handled in the finally block below
+            connection = _get_pool().get_connection()
+        except mysql.connector.Error as e:
+            last_error = e
+            continue
+
+        try:
+            # Make sure the borrowed connection is still alive
+            # This quietly reconnects if the server dropped us
+            connection.ping(reconnect=True, attempts=1)
+
+            # Run the statement as a server-side prepared statement
+            # The hot queries stay parsed and planned across calls
+            cursor = connection.cursor(prepared=True)
+            try:
+                # Time the whole round-trip (execute, fetch, and commit)
+                with instrumentation.timed('database.query'):
+                    cursor.execute(statement, params)
+
+                    # Fetch results or note the generated row ID
+                    if fetch:
+                        result = cursor.fetchall()
+                    else:
+                        result = cursor.lastrowid
+
+                    # Commit if requested
+                    if commit:
+                        connection.commit()
+
+                return result
+            finally:
+                cursor.close()
+        except mysql.connector.Error as e:
+            last_error = e
+        finally:
+            # Return the connection to the pool
+            connection.close()
+
+    # All attempts failed
+    raise last_error
+
+
+def _run_async(statement: str, params: tuple = (), commit: bool = False, fetch: bool = False):
+    """
+    Run one prepared statement without blocking the event loop.
+
+    :param statement: The SQL statement with %s placeholders
+    :param params: The statement parameters
+    :param commit: Whether to commit afterward
+    :param fetch: Whether to fetch and return all result rows
+    :return: An awaitable for the result
+    """
+
+    loop = asyncio.get_event_loop()
+    return loop.run_in_executor(_executor, lambda: _run(statement, params, commit, fetch))
+
+
+def _run_many(statement: str, seq_params: list, commit: bool = True):
+    """
+    Run one prepared statement over a batch of parameter tuples.
+
+    This uses the same pooled connection and retry policy as _run, but it
+    binds the whole batch in one executemany round-trip.
+
+    :param statement: The SQL statement with %s placeholders
+    :param seq_params: A list of parameter tuples
+    :param commit: Whether to commit afterward
+    """
+
+    # The last error seen (re-raised if all attempts fail)
+    last_error = None
+
+    for attempt in range(_retry_attempts):
+        # Back off a little between attempts
+        if attempt > 0:
+            time.sleep(_retry_delay)
+
+        try:
+            # Borrow a connection from the pool
+            connection = _get_pool().get_connection()
+        except mysql.connector.Error as e:
+            last_error = e
+            continue
+
+        try:
+            # Make sure the borrowed connection is still alive
+            connection.ping(reconnect=True, attempts=1)
+
+            # Bind the whole batch in one round-trip
+            cursor = connection.cursor(prepared=True)
+            try:
+                # Time the whole round-trip (execute and commit)
+                with instrumentation.timed('database.batch'):
+                    cursor.executemany(statement, seq_params)
+
+                    if commit:
+                        connection.commit()
+
+                return
+            finally:
+                cursor.close()
+        except mysql.connector.Error as e:
+            last_error = e
+        finally:
+            connection.close()
+
+    # All attempts failed
+    raise last_error
+
+
+def _seed_student_ids():
+    """
+    Seed the local student ID counter from the database.
+
+    This is a no-op once the counter is seeded, so it's safe to call again
+    whenever a caller needs the counter and the first attempt failed.
+    """
+
+    global _next_student_id
+
+    with _next_student_id_lock:
+        # Already seeded, so nothing to do
+        if _next_student_id is not None:
+            return
+
+        # Seed the local ID counter past everything the server knows about
+        rows = _run("""SELECT MAX(Studentid) FROM Students""", fetch=True)
+        highest = rows[0][0] if rows and rows[0][0] is not None else 0
+        _next_student_id = highest + 1
+
+
+def startJournal():
+    """
+    Start the write-behind journal.
+
+    This seeds the local student ID counter from the database and spawns the
+    background flusher thread. Call it once during startup.
+
+    A dead database doesn't stop the journal from starting: the counter
+    seeds lazily on the first insert that finds the server back, and until
+    then the operation runs read-only against the local snapshot.
+    """
+
+    global _journal_thread
+
+    # Seed the local ID counter, but don't let a dead database kill startup
+    try:
+        _seed_student_ids()
+    except mysql.connector.Error as e:
+        print('Could not seed student IDs (database unreachable?):', e)
+
+    # Expose the journal backlog as a gauge
+    instrumentation.gauge('database.journal.depth', _journal.qsize)
 
-#Connect to SQL Server
-connection = mysql.connector.connect(
-        host="localhost",
-        user="root",
-        passwd="password",
-        database="Cozmo"
-)
+    # Spawn the flusher
+    _journal_stop.clear()
+    _journal_thread = Thread(target=_journal_main, name='DatabaseJournal', daemon=True)
+    _journal_thread.start()
+
+
+def stopJournal():
+    """
+    Stop the write-behind journal, flushing anything still queued.
+    """
+
+    global _journal_thread
+
+    if _journal_thread is not None:
+        # Ask the flusher to wind down
+        _journal_stop.set()
+
+        # Wait for it to finish its final flush
+        _journal_thread.join()
+        _journal_thread = None
+
+
+def recordSighting(studentID):
+    """
+    Record that a student was just seen.
+
+    This only appends to the journal, so it returns immediately. The
+    Date_seen update lands on the server at the next flush.
+
+    :param studentID: The student ID
+    """
+
+    dateFormat = datetime.now().strftime('%Y-%m-%d %H:%M:%S')
+    _journal.put(('sighting', studentID, dateFormat))
+
+
+def insertNewStudentQueued(studentName, imageID):
+    """
+    Queue insertion of a new student and return their ID immediately.
+
+    The ID is assigned locally from the seeded counter, so callers (like
+    add_identity) can proceed without waiting on a commit.
+
+    :param studentName: The student name
+    :param imageID: The face identity payload
+    :return: The locally assigned student ID
+    :raises mysql.connector.Error: If the counter is unseeded and the
+                                   database is still unreachable
+    """
+
+    global _next_student_id
+
+    # Make sure the counter is seeded (lazily, if startup couldn't)
+    # Without a seed there's no safe ID to hand out
+    _seed_student_ids()
+
+    with _next_student_id_lock:
+        # Allocate the next local ID
+        studentID = _next_student_id
+        _next_student_id = studentID + 1
+
+    # Queue the insert for the next flush
+    _journal.put(('insert', studentID, studentName, imageID))
+
+    return studentID
+
+
+def _journal_main():
+    """
+    Main function of the journal flusher thread.
+
+    This drains the journal about once a second and batches the entries to
+    MySQL with executemany. Failed batches are requeued for the next flush.
+    """
+
+    while True:
+        # Wait out the flush interval (or leave promptly on shutdown)
+        stopping = _journal_stop.wait(timeout=_journal_flush_interval)
+
+        # Drain everything currently queued
+        entries = []
+        while True:
+            try:
+                entries.append(_journal.get_nowait())
+            except queue.Empty:
+                break
+
+        # If there is anything to flush
+        if entries:
+            # Split the batch by kind
+            sighting_entries = [e for e in entries if e[0] == 'sighting']
+            insert_entries = [e for e in entries if e[0] == 'insert']
+
+            # The entries whose batch failed this flush
+            failed = []
+
+            # Inserts go first so sightings of brand-new students land
+            # A requeued batch may have partially committed before its flush
+            # failed, so the server treats a duplicate key as already applied
+            # (INSERT IGNORE) instead of wedging the journal on IntegrityError
+            if insert_entries:
+                try:
+                    _run_many("""INSERT IGNORE INTO Students(Studentid, Name, Image) VALUES(%s, %s, %s)""",
+                              [(sid, name, image) for (kind, sid, name, image) in insert_entries])
+                except mysql.connector.Error:
+                    failed.extend(insert_entries)
+
+            if sighting_entries:
+                try:
+                    _run_many("""UPDATE Students SET Date_seen = %s WHERE Studentid = %s""",
+                              [(date, sid) for (kind, sid, date) in sighting_entries])
+                except mysql.connector.Error:
+                    failed.extend(sighting_entries)
+
+            if failed:
+                # Put only the failed batches back for the next flush
+                for entry in failed:
+                    _journal.put(entry)
+
+                # Don't spin on a dead server during shutdown
+                if stopping:
+                    print('Database journal could not flush; dropping', len(failed), 'entries')
+                    break
+
+        # Leave once stopped and drained
+        if stopping and _journal.empty():
+            break
 
-dateTime = datetime.now()
-dateFormat = dateTime.strftime('%Y-%m-%d %H:%M:%S')
-myCursor = connection.cursor()
 
 # Retrieve and return 'Studentid' & 'imageID' pairs from db
 def loadStudents():
-    selectQuery = """SELECT Studentid, Image FROM Students"""
-    myCursor.execute(selectQuery)
-    retrieveAll = myCursor.fetchall()
-
-    if retrieveAll is not None:
-        pairs=[]  # NOTE(tyler): Keep a list
-        for studentPairs in retrieveAll:
-            #print(studentPairs)
+    rows = _run("""SELECT Studentid, Image FROM Students""", fetch=True)
+
+    if rows is not None:
+        pairs = []  # NOTE(tyler): Keep a list
+        for studentPairs in rows:
             pairs.append(studentPairs)
         return pairs
 
+
+# Stream 'Studentid' & 'Image' pairs from db in batches;
+# Yields lists of up to batchSize rows, so the whole table never sits in
+# memory twice and the caller can start working on the first batch while
+# the rest is still coming over the wire
+def loadStudentsBatched(batchSize=256):
+    # Borrow a connection for the whole stream
+    connection = _get_pool().get_connection()
+    try:
+        # Make sure the borrowed connection is still alive
+        connection.ping(reconnect=True, attempts=1)
+
+        # An unbuffered cursor leaves the result set on the server and
+        # streams rows down as we fetch them
+        cursor = connection.cursor()
+        try:
+            cursor.execute("""SELECT Studentid, Image FROM Students""")
+
+            while True:
+                # Pull down the next batch of rows
+                with instrumentation.timed('database.stream'):
+                    rows = cursor.fetchmany(batchSize)
+
+                # An empty batch means the stream is done
+                if not rows:
+                    break
+
+                yield rows
+        finally:
+            cursor.close()
+    finally:
+        # Return the connection to the pool
+        connection.close()
+
+
+# Stream full rows for a specific set of student IDs in batches;
+# Used by the snapshot reconciliation pass, so only the delta moves over
+# the network
+def loadStudentsByIds(studentIDs, batchSize=256):
+    for start in range(0, len(studentIDs), batchSize):
+        chunk = studentIDs[start:start + batchSize]
+
+        # Bind one placeholder per ID in this chunk
+        placeholders = ', '.join(['%s'] * len(chunk))
+        rows = _run(f"""SELECT Studentid, Image FROM Students WHERE Studentid IN ({placeholders})""",
+                    tuple(chunk), fetch=True)
+
+        if rows:
+            yield rows
+
+
 # If studentID not seen by cosmo, insert new student with their name and imageID;
 # Returns 'Studentid'
 def insertNewStudent(studentName, imageID):
-
-    insertStudent = """INSERT INTO Students(Name, Image) VALUES('%s', '%s')""" % (studentName, imageID)
-    myCursor.execute(insertStudent)
-    connection.commit()
+    # The generated AUTO_INCREMENT key comes straight back with the insert
+    studentID = _run("""INSERT INTO Students(Name, Image) VALUES(%s, %s)""", (studentName, imageID), commit=True)
     print("Insertion was a success...")
+    return studentID
 
-    returnID = """SELECT Studentid FROM Students WHERE Name = '%s' AND Image = '%s'""" % (studentName, imageID)
-    myCursor.execute(returnID)
-    fetchID = myCursor.fetchall()
-    if fetchID is not None:
-       for x in fetchID:
-            print("Returning Student's ID..")
-            #print (x[0]) #will return studentID number ? switch orint with return
-            return(x[0])
 
 # If studentID seen by cozmo before, update the Date_seen
 def checkForStudent(studentID):
+    dateFormat = datetime.now().strftime('%Y-%m-%d %H:%M:%S')
 
-    checkUser = """SELECT Studentid FROM Students WHERE Studentid = '%s'""" % (studentID)
-    myCursor.execute(checkUser)
-    check = myCursor.fetchone()
+    check = _run("""SELECT Studentid FROM Students WHERE Studentid = %s""", (studentID,), fetch=True)
 
-    if check is not None:
-        updateExistingUser = """UPDATE Students SET Date_seen = '%s' WHERE Image = '%s'""" % (dateFormat, studentID)
-        myCursor.execute(updateExistingUser)
-        connection.commit() #Needed To Update Database
+    if check:
+        _run("""UPDATE Students SET Date_seen = %s WHERE Studentid = %s""", (dateFormat, studentID), commit=True)
         print("Studentid has been seen, updating 'Date_seen' Column;")
 
+
 # Delete Student based on their 'Studentid'
 def deleteStudent(studentID):
+    studID = _run("""SELECT Studentid FROM Students WHERE Studentid = %s""", (studentID,), fetch=True)
 
-    selectQuery = """SELECT Studentid FROM Students WHERE Studentid = '%s'""" % (studentID)
-    myCursor.execute(selectQuery)
-    studID = myCursor.fetchone()
-
-    if studID is not None:
-        delete = """DELETE FROM Students WHERE Studentid = '%s'""" % (studentID)
-        myCursor.execute(delete)
-        print("Student ID =",studID[0], "was deleted from the Database")
-        connection.commit()
+    if studID:
+        _run("""DELETE FROM Students WHERE Studentid = %s""", (studentID,), commit=True)
+        print("Student ID =", studID[0][0], "was deleted from the Database")
+    else:
+        print("Student ID =", studentID, "not in the current Database")
 
-    if studID is None:
-        print("Student ID =",studentID,"not in the current Database")
 
 # Return only 'Studentid'
 def listStudentIDs():
-    selectQuery = """SELECT Studentid FROM Students"""
-    myCursor.execute(selectQuery)
-    retrieveAll = myCursor.fetchall()
+    rows = _run("""SELECT Studentid FROM Students""", fetch=True)
+
+    if rows is not None:
+        return [studID[0] for studID in rows]
 
-    if retrieveAll is not None:
-        for studID in retrieveAll:
-            #print(studID[0])
-            return (studentPairs[0])
 
 # Based on 'Studentid' list the name and date last seen of that student
 def determineStudent(studentID):
-    select = """SELECT Name, Date_seen FROM Students WHERE StudentID = '%s'""" % (studentID)
-    myCursor.execute(select)
-    obtainName = myCursor.fetchall()
+    obtainName = _run("""SELECT Name, Date_seen FROM Students WHERE StudentID = %s""", (studentID,), fetch=True)
     if obtainName is not None:
-        for x , y in obtainName:
-            print("Student with ID = ",studentID, "is ", x, "and date last seen is", y)
+        for x, y in obtainName:
+            print("Student with ID = ", studentID, "is ", x, "and date last seen is", y)
             return x, y  # NOTE(tyler): Return both the name and the date last seen
 
-#Return name of student who was seen most recently
+
+# Return name of student who was seen most recently
 def returnStudentName():
-    select = """SELECT Name FROM Students WHERE Date_seen = (SELECT MAX(Date_seen) FROM Students)"""
-    myCursor.execute(select)
-    returnName = myCursor.fetchall()
+    returnName = _run("""SELECT Name FROM Students WHERE Date_seen = (SELECT MAX(Date_seen) FROM Students)""",
+                      fetch=True)
     if returnName is not None:
         for x in returnName:
-            #print(x[0])
-            return(x[0])
+            return x[0]
+
+
+#
+# Async variants
+# These run the same statements on the executor, so the asyncio event loop
+# (and both robot drivers with it) never blocks on a MySQL round-trip
+#
+
+async def loadStudentsAsync():
+    return await _run_async("""SELECT Studentid, Image FROM Students""", fetch=True)
+
+
+async def insertNewStudentAsync(studentName, imageID):
+    return await _run_async("""INSERT INTO Students(Name, Image) VALUES(%s, %s)""", (studentName, imageID),
+                            commit=True)
+
+
+async def checkForStudentAsync(studentID):
+    dateFormat = datetime.now().strftime('%Y-%m-%d %H:%M:%S')
+    return await _run_async("""UPDATE Students SET Date_seen = %s WHERE Studentid = %s""", (dateFormat, studentID),
+                            commit=True)
+
 
-#store face as base 64 text string? = 'text' data type(pretty large numbers)
-if __name__ == "__main__":
+async def determineStudentAsync(studentID):
+    rows = await _run_async("""SELECT Name, Date_seen FROM Students WHERE StudentID = %s""", (studentID,), fetch=True)
+    if rows:
+        return rows[0]
 
-    #insertNewStudent("NEW5", 1000)
-    #checkForStudent(3)
-    #loadStudents()
-    #deleteStudent(2)
-    #listStudentIDs()
-    #determineStudent(1)
 
-    myCursor.close()
-    connection.close()
+async def returnStudentNameAsync():
+    rows = await _run_async("""SELECT Name FROM Students WHERE Date_seen = (SELECT MAX(Date_seen) FROM Students)""",
+                            fetch=True)
+    if rows:
+        return rows[0][0]
@@ -0,0 +1,191 @@
+#
+# Cozmonaut
+# Copyright 2019 The Cozmonaut Contributors
+#
+
+import time
+from collections import deque
+from threading import Lock
+
+# The instrumentation registry
+# Counters are plain integers, timings keep summary stats plus a small window
+# of recent samples for percentiles, and gauges are callables sampled at
+# report time (e.g. queue depths)
+_lock = Lock()
+_counters = {}
+_timings = {}
+_gauges = {}
+
+# How many recent samples each timing keeps for percentile estimates
+_timing_window = 256
+
+
+class _Timing:
+    """
+    Summary statistics for one timed hot point.
+    """
+
+    __slots__ = ('count', 'total', 'minimum', 'maximum', 'recent')
+
+    def __init__(self):
+        self.count = 0
+        self.total = 0.0
+        self.minimum = None
+        self.maximum = None
+        self.recent = deque(maxlen=_timing_window)
+
+
+def count(name: str, amount: int = 1):
+    """
+    Bump a named counter.
+
+    :param name: The counter name
+    :param amount: The amount to add
+    """
+
+    with _lock:
+        _counters[name] = _counters.get(name, 0) + amount
+
+
+def record(name: str, seconds: float):
+    """
+    Record one timing sample for a named hot point.
+
+    :param name: The timing name
+    :param seconds: The measured duration in seconds
+    """
+
+    with _lock:
+        timing = _timings.get(name)
+        if timing is None:
+            timing = _timings[name] = _Timing()
+
+        timing.count += 1
+        timing.total += seconds
+        timing.minimum = seconds if timing.minimum is None else min(timing.minimum, seconds)
+        timing.maximum = seconds if timing.maximum is None else max(timing.maximum, seconds)
+        timing.recent.append(seconds)
+
+
+class timed:
+    """
+    A context manager that records how long its body took.
+
+    Usage:
+      with instrumentation.timed('face.detection'):
+          ...the hot code...
+    """
+
+    __slots__ = ('_name', '_start')
+
+    def __init__(self, name: str):
+        self._name = name
+
+    def __enter__(self):
+        self._start = time.perf_counter()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        record(self._name, time.perf_counter() - self._start)
+
+
+def gauge(name: str, fn):
+    """
+    Register a named gauge.
+
+    The callable is sampled every time a report is built, so it should be
+    cheap (a qsize or a len, not a round-trip).
+
+    :param name: The gauge name
+    :param fn: A zero-argument callable returning the current value
+    """
+
+    with _lock:
+        _gauges[name] = fn
+
+
+def _percentile(samples: list, fraction: float) -> float:
+    """
+    Estimate a percentile from a sorted sample list.
+
+    :param samples: The sorted samples
+    :param fraction: The percentile as a fraction (e.g. 0.95)
+    :return: The estimated percentile
+    """
+
+    return samples[min(int(len(samples) * fraction), len(samples) - 1)]
+
+
+def report() -> str:
+    """
+    Build a full multi-line statistics report.
+
+    :return: The report text
+    """
+
+    with _lock:
+        lines = []
+
+        if _counters:
+            lines.append('counters:')
+            for name in sorted(_counters):
+                lines.append(f'  {name}: {_counters[name]}')
+
+        if _timings:
+            lines.append('timings (ms):')
+            for name in sorted(_timings):
+                timing = _timings[name]
+                mean = timing.total / timing.count
+                recent = sorted(timing.recent)
+                p50 = _percentile(recent, 0.50)
+                p95 = _percentile(recent, 0.95)
+                lines.append(f'  {name}: n={timing.count} mean={mean * 1000:.1f}'
+                             f' p50={p50 * 1000:.1f} p95={p95 * 1000:.1f} max={timing.maximum * 1000:.1f}')
+
+        if _gauges:
+            lines.append('gauges:')
+            for name in sorted(_gauges):
+                try:
+                    value = _gauges[name]()
+                except Exception as e:
+                    value = f'error: {e}'
+                lines.append(f'  {name}: {value}')
+
+        if not lines:
+            return 'no statistics recorded yet'
+
+        return '\n'.join(lines)
+
+
+def summary_line() -> str:
+    """
+    Build a compact one-line summary for periodic printing.
+
+    :return: The summary text
+    """
+
+    with _lock:
+        parts = []
+
+        for name in sorted(_counters):
+            parts.append(f'{name}={_counters[name]}')
+
+        for name in sorted(_timings):
+            timing = _timings[name]
+            mean = timing.total / timing.count
+            parts.append(f'{name}={mean * 1000:.1f}ms')
+
+        if not parts:
+            return 'stats: (nothing recorded yet)'
+
+        return 'stats: ' + ' '.join(parts)
+
+
+def reset():
+    """
+    Clear all counters and timings (gauges stay registered).
+    """
+
+    with _lock:
+        _counters.clear()
+        _timings.clear()
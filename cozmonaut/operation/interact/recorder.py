@@ -0,0 +1,133 @@
+#
+# Cozmonaut
+# Copyright 2019 The Cozmonaut Contributors
+#
+
+import os
+import queue
+import time
+from threading import Thread
+
+import PIL.Image
+
+from cozmonaut.operation.interact import instrumentation
+
+# The capacity of the frame ring
+# At the 15 fps camera cadence this is about four seconds of slack before
+# frames start dropping, which covers the occasional slow disk flush
+_ring_capacity = 64
+
+
+class FrameRecorder:
+    """
+    An opt-in recorder that streams camera frames to disk.
+
+    Frames are handed over on the camera callback with a non-blocking ring
+    push, and a dedicated writer thread drains the ring with sequential
+    writes. If the disk falls behind, frames drop rather than block the
+    callback, so recording can stay on all day without disturbing the
+    camera cadence.
+
+    Each robot gets its own subdirectory, and filenames carry a millisecond
+    timestamp plus a sequence number, so a recording sorts back into capture
+    order. The files are plain JPEGs, which is exactly what the offline
+    replay benchmark loads.
+    """
+
+    def __init__(self, directory: str, letter: str):
+        """
+        Initialize the frame recorder.
+
+        :param directory: The base recording directory
+        :param letter: The robot letter (for the per-robot subdirectory)
+        """
+
+        # The per-robot output directory
+        self._directory = os.path.join(directory, f'robot-{letter.lower()}')
+
+        # The robot letter (for operator-facing messages)
+        self._letter = letter
+
+        # The frame ring between the camera callback and the writer thread
+        self._ring = queue.Queue(maxsize=_ring_capacity)
+
+        # The sequence number of the next frame to write
+        self._sequence = 0
+
+        # The writer thread
+        self._thread: Thread = None
+
+    def start(self):
+        """
+        Start the frame recorder.
+        """
+
+        # Create the output directory if needed
+        os.makedirs(self._directory, exist_ok=True)
+
+        # Spawn the writer thread
+        self._thread = Thread(target=self._thread_writer_main)
+        self._thread.start()
+
+    def stop(self):
+        """
+        Stop the frame recorder.
+
+        Frames already in the ring are flushed before the writer exits.
+        """
+
+        # Send the shutdown sentinel through the ring
+        # The writer drains everything queued ahead of it first
+        self._ring.put(None)
+
+        # Wait for the writer thread to die
+        self._thread.join()
+        self._thread = None
+
+    def submit(self, image: PIL.Image):
+        """
+        Submit one camera frame for recording.
+
+        This is the hot-path half: a single non-blocking push onto the
+        ring. If the ring is full, the frame drops and a counter bumps.
+
+        :param image: The camera frame
+        """
+
+        try:
+            self._ring.put_nowait(image)
+        except queue.Full:
+            # The writer fell behind; drop rather than block the callback
+            instrumentation.count('recorder.frames.dropped')
+
+    def _thread_writer_main(self):
+        """
+        Main function for the writer thread.
+
+        This drains the ring with sequential writes to the per-robot
+        directory. All the encoding and disk cost lives here, off the
+        camera callback.
+        """
+
+        while True:
+            # Wait for the next frame (or the shutdown sentinel)
+            image = self._ring.get()
+
+            # If this is the shutdown sentinel
+            if image is None:
+                break
+
+            # Timestamp plus sequence keeps filenames unique and sortable
+            timestamp = int(time.time() * 1000)
+            name = f'{timestamp:013d}-{self._sequence:06d}.jpg'
+            self._sequence += 1
+
+            try:
+                # Encode and append the frame
+                image.convert('RGB').save(os.path.join(self._directory, name), 'JPEG', quality=85)
+            except OSError as e:
+                # The disk is having a bad day; say so and soldier on
+                print(f'Failed to record a frame for robot {self._letter}: {e}')
+                continue
+
+            instrumentation.count('recorder.frames.written')
@@ -37,6 +37,15 @@ class ConversationAction(ABC):
     An abstract conversation action.
     """
 
+    async def prepare(self):
+        """
+        Prepare the action ahead of its performance.
+
+        The default implementation does nothing. Actions with slow setup
+        (like database lookups) override this so the conversation engine can
+        overlap it with the previous action's playback.
+        """
+
     @abstractmethod
     async def perform(self, robot_a: cozmo.robot.Robot, robot_b: cozmo.robot.Robot):
         """
@@ -61,6 +70,14 @@ class ConversationActionGroup(ConversationAction):
 
         self._subs = subs
 
+    async def prepare(self):
+        """
+        Prepare the action by preparing its sub-actions simultaneously.
+        """
+
+        # Fire off each sub-action's preparation simultaneously
+        await asyncio.gather(*(action.prepare() for action in self._subs))
+
     async def perform(self, robot_a: cozmo.robot.Robot, robot_b: cozmo.robot.Robot):
         """
         Perform the action by running its sub-actions simultaneously.
@@ -102,8 +119,24 @@ class ConversationActionSayText(ConversationAction):
         self._pitch = pitch
         self._human = human
 
-        # Format the text
-        self._format_text()
+        # The formatted text staged by prepare
+        # This resolves fresh for each performance, since the name of the
+        # last-seen person changes between conversations
+        self._prepared_text = None
+
+    async def prepare(self):
+        """
+        Prepare the action by formatting the text.
+
+        The name lookup is a blocking database round-trip, so it runs on the
+        database executor here instead of stalling say_text later.
+        """
+
+        # Get the name of the last seen person
+        name_last_seen = await database.returnStudentNameAsync() or 'Bob'
+
+        # Format the last name seen
+        self._prepared_text = self._text.format(self._text, name_last_seen=name_last_seen)
 
     async def perform(self, robot_a: cozmo.robot.Robot, robot_b: cozmo.robot.Robot):
         """
@@ -113,6 +146,14 @@ class ConversationActionSayText(ConversationAction):
         :param robot_b: The robot B instance
         """
 
+        # Prepare inline if the pipeline didn't get to us ahead of time
+        if self._prepared_text is None:
+            await self.prepare()
+
+        # Consume the staged text so the next performance re-resolves it
+        text = self._prepared_text
+        self._prepared_text = None
+
         # The robots taking part
         robots = []
         if self._roles == ConversationRoles.a:
@@ -129,7 +170,7 @@ class ConversationActionSayText(ConversationAction):
         # Say the text simultaneously on each robot taking part
         for robot in robots:
             coros.append(robot.say_text(
-                text=self._text,
+                text=text,
                 use_cozmo_voice=not self._human,
                 duration_scalar=self._duration,
                 voice_pitch=self._pitch,
@@ -138,13 +179,6 @@ class ConversationActionSayText(ConversationAction):
         # Wait for coroutines to complete
         await asyncio.gather(*coros)
 
-    def _format_text(self):
-        # Get the name of the last seen person
-        name_last_seen = database.returnStudentName() or 'Bob'
-
-        # Format the last name seen
-        self._text = self._text.format(self._text, name_last_seen=name_last_seen)
-
 
 class ConversationActionAnimTrigger(ConversationAction):
     """
@@ -221,16 +255,47 @@ class Conversation:
         """
         Perform the conversation with robots.
 
+        Actions play in sequence, but each action's preparation (e.g. the
+        database lookup behind say-text formatting) overlaps with the previous
+        action's playback, so dialogue flows without inter-line gaps.
+
         :param robot_a: The robot A instance
         :param robot_b: The robot B instance
         """
 
+        # Nothing to do for an empty script
+        if not self._actions:
+            return
+
+        # Prepare the opening action up front
+        await self._actions[0].prepare()
+
         # Perform each action in sequence
-        for action in self._actions:
-            await action.perform(
-                robot_a=robot_a,
-                robot_b=robot_b,
-            )
+        for i, action in enumerate(self._actions):
+            # Start preparing the next action while this one plays
+            prepare_next = None
+            if i + 1 < len(self._actions):
+                prepare_next = asyncio.ensure_future(self._actions[i + 1].prepare())
+
+            try:
+                await action.perform(
+                    robot_a=robot_a,
+                    robot_b=robot_b,
+                )
+
+                # Make sure the next action is ready before handing off to it
+                if prepare_next is not None:
+                    await prepare_next
+                    prepare_next = None
+            finally:
+                # If the perform was cut short (force-cancel does this), reel
+                # in the in-flight preparation so its round-trip isn't leaked
+                if prepare_next is not None:
+                    prepare_next.cancel()
+                    try:
+                        await prepare_next
+                    except (asyncio.CancelledError, Exception):
+                        pass
 
 
 class ServiceConvo(Service):
@@ -241,13 +306,33 @@ class ServiceConvo(Service):
     def __init__(self):
         super().__init__()
 
+        # The precompiled conversation cache
+        # This maps each name to the mtime of its source file and the parsed
+        # conversation, so load() is a dict lookup after the initial parse
+        self._cache = {}
+
+        # The cached conversation name listing
+        # This only refreshes when the data directory itself changes
+        self._list_cache = None
+        self._list_cache_mtime = None
+
     def start(self):
         """
         Start the Convo service.
+
+        All available conversations are parsed up front, so the robots begin
+        speaking without a disk-bound pause later on.
         """
 
         super().start()
 
+        # Precompile every conversation we can find
+        for name in self.list():
+            try:
+                self.load(name)
+            except (OSError, ValueError, RuntimeError) as e:
+                print(f'Failed to preload conversation {name}: {e}')
+
     def stop(self):
         """
         Stop the Convo service.
@@ -255,22 +340,31 @@ class ServiceConvo(Service):
 
         super().stop()
 
-    @staticmethod
-    def list() -> List[str]:
+    def list(self) -> List[str]:
         """
         Retrieve a summary of all available conversations.
 
         :return: A list of names of known conversations
         """
 
-        # List all files in the conversation directory
-        return [file[:-5] for file in os.listdir(_data_directory)
-                if os.path.isfile(os.path.join(_data_directory, file)) and file.endswith('.json')]
+        # The data directory mtime changes when files come or go
+        directory_mtime = os.path.getmtime(_data_directory)
+
+        # Refresh the cached listing only when the directory changed
+        if self._list_cache is None or directory_mtime != self._list_cache_mtime:
+            self._list_cache = [file[:-5] for file in os.listdir(_data_directory)
+                                if os.path.isfile(os.path.join(_data_directory, file)) and file.endswith('.json')]
+            self._list_cache_mtime = directory_mtime
+
+        return self._list_cache
 
     def load(self, name: str) -> Conversation:
         """
         Load a conversation by name.
 
+        Parsed conversations are cached, so repeat loads return the same
+        precompiled object unless the source file changed on disk.
+
         :param name: The conversation name
         :return: The conversation
         """
@@ -278,6 +372,14 @@ class ServiceConvo(Service):
         # Create the target file name for the conversation
         filename = os.path.join(_data_directory, f'{name}.json')
 
+        # The source file mtime (this doubles as existence check)
+        file_mtime = os.path.getmtime(filename)
+
+        # Serve from the cache unless the file changed since we parsed it
+        cached = self._cache.get(name)
+        if cached is not None and cached[0] == file_mtime:
+            return cached[1]
+
         # Open the conversation file
         with open(filename) as file:
             # Load conversation data
@@ -295,11 +397,16 @@ class ServiceConvo(Service):
                 actions.append(self._load_action(action))
 
             # Create the conversation
-            return Conversation(
+            convo = Conversation(
                 name=name,
                 actions=actions,
             )
 
+            # Remember the parse for next time
+            self._cache[name] = (file_mtime, convo)
+
+            return convo
+
     def _load_action(self, data):
         """
         Load an action.
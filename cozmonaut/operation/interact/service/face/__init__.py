@@ -3,10 +3,12 @@
 # Copyright 2019 The Cozmonaut Contributors
 #
 
-import time
+import asyncio
+import os
+from collections import deque
 from concurrent.futures import Future
 from concurrent.futures.thread import ThreadPoolExecutor
-from threading import Thread, Lock
+from threading import Event, Thread, Lock
 from typing import List, Tuple, Dict, Optional
 
 import PIL.Image
@@ -15,18 +17,167 @@ import dlib
 import numpy
 from pkg_resources import resource_filename
 
+from cozmonaut.operation.interact import instrumentation
 from cozmonaut.operation.interact.service import Service
 
-# The face detector
-_detector = dlib.get_frontal_face_detector()
+# The native frame preprocessing extension (optional)
+# If it didn't get built, we fall back to the OpenCV routines
+try:
+    from cozmonaut.operation.interact.service.face import _frameprep
+except ImportError:
+    _frameprep = None
 
-# The face pose predictor
-_predictor_serialized_file_name = resource_filename(__name__, "data/shape_predictor_68_face_landmarks.dat")
-_predictor = dlib.shape_predictor(_predictor_serialized_file_name)
 
-# The face recognition model
-_model_file_serialized_file_name = resource_filename(__name__, "data/dlib_face_recognition_resnet_model_v1.dat")
-_model = dlib.face_recognition_model_v1(_model_file_serialized_file_name)
+def _crop_roi(image_np: numpy.ndarray, left: int, top: int, right: int, bottom: int):
+    """
+    Crop a padded region of interest out of a frame.
+
+    :param image_np: The frame to crop from
+    :param left: The left edge of the box
+    :param top: The top edge of the box
+    :param right: The right edge of the box
+    :param bottom: The bottom edge of the box
+    :return: A (roi, (x, y)) pair giving the crop and its frame-space origin
+    """
+
+    # Pad the box and clamp it to the frame bounds
+    x0 = max(int(left) - _roi_padding, 0)
+    y0 = max(int(top) - _roi_padding, 0)
+    x1 = min(int(right) + _roi_padding, image_np.shape[1])
+    y1 = min(int(bottom) + _roi_padding, image_np.shape[0])
+
+    # Copy the crop out so the full frame can be freed
+    return image_np[y0:y1, x0:x1].copy(), (x0, y0)
+
+
+def _prepare_frame(image: PIL.Image) -> numpy.ndarray:
+    """
+    Prepare a raw camera frame for tracking and detection.
+
+    This upscales the frame by 2x and denoises it with a 3x3 median filter. It
+    is done exactly once per frame, and the result is shared by the
+    tracker-update path and the detection thread.
+
+    :param image: The raw camera frame
+    :return: The prepared frame as a numpy matrix
+    """
+
+    # View the PIL image as a numpy matrix
+    # Unlike numpy.array, numpy.asarray does not copy the pixel data
+    image_np = numpy.asarray(image)
+
+    # If the native extension is available
+    if _frameprep is not None:
+        # Frame dimensions
+        height, width = image_np.shape[:2]
+
+        # Upscale and denoise in one native pass over the raw buffer
+        prepared = _frameprep.prepare(numpy.ascontiguousarray(image_np), width, height)
+
+        # View the shared output buffer as a numpy matrix (again, no copy)
+        return numpy.frombuffer(prepared, dtype=numpy.uint8).reshape((2 * height, 2 * width, 3))
+
+    # Fall back to the OpenCV preprocessing pair
+    image_np = cv2.pyrUp(image_np)
+    image_np = cv2.medianBlur(image_np, 3)
+    return image_np
+
+
+# The initial capacity of the identity matrix (in rows)
+_identity_matrix_initial_capacity = 256
+
+# The cluster radius for the identity index
+# New identities within this distance of a cluster leader join that cluster
+_identity_index_cluster_radius = 0.45
+
+# The padding around a tracker's box when cropping its region of interest
+# Recognition only ever reads the face rectangle, so trackers keep a small
+# padded crop instead of the full upscaled frame
+_roi_padding = 32
+
+# The capacity of the incoming frame ring
+# When the ring is full, the oldest frame is dropped in favor of the newest
+_frame_ring_capacity = 4
+
+# The detection interval bounds (in seconds)
+# The detection loop runs at the fast end while a caller is waiting on a new
+# track, and it backs off exponentially toward the slow end while idle
+_detection_interval_min = 0.1
+_detection_interval_max = 3.0
+
+# The maximum box drift tolerated by the recognition memo
+# This is a fraction of the box size; a track whose box moved or resized less
+# than this since its last recognition serves the remembered result
+_recognition_memo_max_drift = 0.2
+
+# The face detector, pose predictor, and recognition model
+# Deserializing the model files reads ~100 MB off disk, so these load lazily
+# on first use (or ahead of time via preload_models) rather than at import
+# time, and the one resident copy is shared by every face service
+_models_lock = Lock()
+_detector = None
+_predictor = None
+_model = None
+
+
+def _get_detector() -> dlib.fhog_object_detector:
+    """
+    Get the face detector, loading it on first use.
+
+    :return: The face detector
+    """
+
+    global _detector
+
+    with _models_lock:
+        if _detector is None:
+            _detector = dlib.get_frontal_face_detector()
+        return _detector
+
+
+def _get_predictor() -> dlib.shape_predictor:
+    """
+    Get the face pose predictor, loading it on first use.
+
+    :return: The face pose predictor
+    """
+
+    global _predictor
+
+    with _models_lock:
+        if _predictor is None:
+            _predictor = dlib.shape_predictor(
+                resource_filename(__name__, "data/shape_predictor_68_face_landmarks.dat"))
+        return _predictor
+
+
+def _get_model() -> dlib.face_recognition_model_v1:
+    """
+    Get the face recognition model, loading it on first use.
+
+    :return: The face recognition model
+    """
+
+    global _model
+
+    with _models_lock:
+        if _model is None:
+            _model = dlib.face_recognition_model_v1(
+                resource_filename(__name__, "data/dlib_face_recognition_resnet_model_v1.dat"))
+        return _model
+
+
+def preload_models():
+    """
+    Load all the face models now instead of at first use.
+
+    Call this from a background thread while something slow (like the Cozmo
+    connection dance) is happening, and the load time disappears entirely.
+    """
+
+    _get_detector()
+    _get_predictor()
+    _get_model()
 
 
 class DetectedFace:
@@ -108,17 +259,399 @@ class RecognizedFace(DetectedFace):
         self._ident = value
 
 
+class FaceIdentityStore:
+    """
+    A store of known face identities.
+
+    The store is read-mostly and safe to share between face services, so one
+    copy of the identity matrix and its index can serve every robot.
+    """
+
+    def __init__(self):
+        # The face identities
+        # All identity vectors live in one contiguous float32 matrix, one row
+        # per face, so matching is a single vectorized distance computation
+        # The matrix grows by doubling as identities arrive
+        self._identity_matrix = numpy.zeros((_identity_matrix_initial_capacity, 128), dtype=numpy.float32)
+        self._identity_count = 0
+        self._identity_fids: List[int] = []  # Row index -> face ID
+        self._identity_rows: Dict[int, int] = {}  # Face ID -> row index
+        self._identities_lock = Lock()
+
+        # The identity index
+        # This is an incremental ball-tree-style structure: identities are
+        # grouped into clusters around leader vectors, and lookups prune whole
+        # clusters with the triangle inequality before touching their members
+        self._index_leaders = numpy.zeros((_identity_matrix_initial_capacity, 128), dtype=numpy.float32)
+        self._index_radii = numpy.zeros(_identity_matrix_initial_capacity, dtype=numpy.float32)
+        self._index_cluster_count = 0
+        self._index_members: List[List[int]] = []  # Cluster -> face IDs
+        self._index_cluster_of: Dict[int, int] = {}  # Face ID -> cluster
+
+    def add_identity(self, fid: int, ident: Tuple[float, ...]):
+        """
+        Add a new face identity to the store.
+
+        :param fid: The face ID
+        :param ident: The face identity (128-dimensional vector)
+        """
+
+        with self._identities_lock:
+            # If this face ID is already known, just overwrite its row
+            row = self._identity_rows.get(fid)
+            if row is not None:
+                self._identity_matrix[row] = ident
+
+                # Re-file the identity in the index, since the new vector may
+                # sit outside its old cluster's radius and a stale filing
+                # breaks the triangle-inequality pruning bound
+                self._index_remove(fid)
+                self._index_add(fid, self._identity_matrix[row])
+                return
+
+            # If the matrix is full, double its capacity
+            if self._identity_count == self._identity_matrix.shape[0]:
+                grown = numpy.zeros((self._identity_matrix.shape[0] * 2, 128), dtype=numpy.float32)
+                grown[:self._identity_count] = self._identity_matrix[:self._identity_count]
+                self._identity_matrix = grown
+
+            # Append the identity to the next free row
+            row = self._identity_count
+            self._identity_matrix[row] = ident
+            self._identity_fids.append(fid)
+            self._identity_rows[fid] = row
+            self._identity_count += 1
+
+            # File the identity into the index
+            self._index_add(fid, self._identity_matrix[row])
+
+    def add_identities(self, fids: List[int], idents: numpy.ndarray):
+        """
+        Add a batch of face identities to the store.
+
+        The whole batch is block-copied into the identity matrix in one go,
+        so bulk loading at startup avoids per-row Python object churn.
+
+        :param fids: The face IDs, one per row of idents
+        :param idents: The face identities as an N-by-128 matrix
+        """
+
+        with self._identities_lock:
+            # Rows needed once the batch lands
+            needed = self._identity_count + len(fids)
+
+            # If the matrix is too small, grow it by doubling
+            capacity = self._identity_matrix.shape[0]
+            while capacity < needed:
+                capacity *= 2
+            if capacity != self._identity_matrix.shape[0]:
+                grown = numpy.zeros((capacity, 128), dtype=numpy.float32)
+                grown[:self._identity_count] = self._identity_matrix[:self._identity_count]
+                self._identity_matrix = grown
+
+            # Block-copy the whole batch into the matrix
+            base = self._identity_count
+            self._identity_matrix[base:needed] = idents
+
+            # File each row into the side tables and the index
+            for i, fid in enumerate(fids):
+                row = base + i
+                self._identity_fids.append(fid)
+                self._identity_rows[fid] = row
+                self._index_add(fid, self._identity_matrix[row])
+
+            self._identity_count = needed
+
+    def known_fids(self) -> set:
+        """
+        Get the set of face IDs currently in the store.
+
+        :return: A set of face IDs
+        """
+
+        with self._identities_lock:
+            return set(self._identity_fids)
+
+    def save_snapshot(self, directory: str):
+        """
+        Write a local snapshot of the identity store.
+
+        The snapshot is two plain .npy files: the face IDs and the packed
+        float32 identity matrix. Each file is written to a sidecar and
+        renamed into place, so a crash mid-write can't leave a torn
+        snapshot. An empty store writes nothing, so a day with no database
+        can't clobber a good snapshot.
+
+        :param directory: The snapshot directory
+        """
+
+        with self._identities_lock:
+            # Copy out under the lock so the snapshot is consistent
+            fids = numpy.asarray(self._identity_fids, dtype=numpy.int64)
+            idents = self._identity_matrix[:self._identity_count].copy()
+
+        # Refuse to clobber a good snapshot with an empty one
+        if len(fids) == 0:
+            return
+
+        os.makedirs(directory, exist_ok=True)
+
+        for name, array in (('identity-fids.npy', fids), ('identity-matrix.npy', idents)):
+            # Write the sidecar, then rename it into place atomically
+            sidecar = os.path.join(directory, name.replace('.npy', '.tmp.npy'))
+            numpy.save(sidecar, array)
+            os.replace(sidecar, os.path.join(directory, name))
+
+    def load_snapshot(self, directory: str) -> int:
+        """
+        Load a local snapshot into the identity store.
+
+        The identity matrix is memory-mapped, so loading costs one map
+        plus one block copy into the store regardless of how many
+        identities the snapshot holds.
+
+        :param directory: The snapshot directory
+        :return: The number of identities loaded (zero if no usable snapshot)
+        """
+
+        fids_path = os.path.join(directory, 'identity-fids.npy')
+        idents_path = os.path.join(directory, 'identity-matrix.npy')
+
+        try:
+            fids = numpy.load(fids_path)
+            idents = numpy.load(idents_path, mmap_mode='r')
+        except (OSError, ValueError):
+            # No snapshot (or a mangled one); the caller falls back to the database
+            return 0
+
+        # Refuse a snapshot whose halves don't line up
+        if len(fids) == 0 or idents.ndim != 2 or idents.shape != (len(fids), 128):
+            return 0
+
+        # Register the whole snapshot in one block copy
+        self.add_identities([int(fid) for fid in fids], idents)
+
+        return len(fids)
+
+    def remove_identity(self, fid: int):
+        """
+        Remove a face identity from the store.
+
+        :param fid: The face ID
+        """
+
+        with self._identities_lock:
+            # The row occupied by the doomed identity
+            row = self._identity_rows.pop(fid)
+
+            # Move the last row into the vacated slot to keep the matrix dense
+            last = self._identity_count - 1
+            if row != last:
+                self._identity_matrix[row] = self._identity_matrix[last]
+                moved_fid = self._identity_fids[last]
+                self._identity_fids[row] = moved_fid
+                self._identity_rows[moved_fid] = row
+
+            # Shrink by one row
+            self._identity_fids.pop()
+            self._identity_count -= 1
+
+            # Pull the identity out of the index
+            self._index_remove(fid)
+
+    def _index_add(self, fid: int, ident: numpy.ndarray):
+        """
+        File a face identity into the index.
+
+        The identities lock must be held by the caller.
+
+        :param fid: The face ID
+        :param ident: The face identity (row of the identity matrix)
+        """
+
+        # If any clusters exist
+        if self._index_cluster_count > 0:
+            # Distances from the identity to all cluster leaders
+            distances = numpy.linalg.norm(self._index_leaders[:self._index_cluster_count] - ident, axis=1)
+
+            # The nearest cluster leader
+            nearest = int(numpy.argmin(distances))
+
+            # If the identity is close enough to join that cluster
+            if distances[nearest] <= _identity_index_cluster_radius:
+                # Add the identity as a member
+                self._index_members[nearest].append(fid)
+                self._index_cluster_of[fid] = nearest
+
+                # Widen the cluster radius if needed
+                if distances[nearest] > self._index_radii[nearest]:
+                    self._index_radii[nearest] = distances[nearest]
+
+                return
+
+        # No cluster wanted it, so the identity leads a new cluster
+        # If the leader matrix is full, double its capacity
+        if self._index_cluster_count == self._index_leaders.shape[0]:
+            grown_leaders = numpy.zeros((self._index_leaders.shape[0] * 2, 128), dtype=numpy.float32)
+            grown_leaders[:self._index_cluster_count] = self._index_leaders[:self._index_cluster_count]
+            self._index_leaders = grown_leaders
+
+            grown_radii = numpy.zeros(self._index_radii.shape[0] * 2, dtype=numpy.float32)
+            grown_radii[:self._index_cluster_count] = self._index_radii[:self._index_cluster_count]
+            self._index_radii = grown_radii
+
+        # Record the new cluster
+        cluster = self._index_cluster_count
+        self._index_leaders[cluster] = ident
+        self._index_radii[cluster] = 0
+        self._index_members.append([fid])
+        self._index_cluster_of[fid] = cluster
+        self._index_cluster_count += 1
+
+    def _index_remove(self, fid: int):
+        """
+        Pull a face identity out of the index.
+
+        The identities lock must be held by the caller. Empty clusters are
+        kept around (their radius prunes them cheaply), so removal is O(1).
+
+        :param fid: The face ID
+        """
+
+        # Unfile the identity from its cluster
+        cluster = self._index_cluster_of.pop(fid)
+        self._index_members[cluster].remove(fid)
+
+    def _index_search(self, ident: numpy.ndarray, threshold: float) -> Tuple[int, float]:
+        """
+        Find the nearest known identity within a distance threshold.
+
+        The identities lock must be held by the caller. Clusters whose leader
+        is provably too far away (by the triangle inequality) are skipped
+        entirely, so lookups scale with the number of nearby clusters rather
+        than the total number of identities.
+
+        :param ident: The query identity
+        :param threshold: The maximum tolerable distance
+        :return: A (face ID, distance) pair, with face ID -1 on no match
+        """
+
+        # Bail early if nothing is indexed
+        if self._index_cluster_count == 0:
+            return -1, threshold
+
+        # Distances from the query to all cluster leaders
+        leader_distances = numpy.linalg.norm(self._index_leaders[:self._index_cluster_count] - ident, axis=1)
+
+        # Clusters that could possibly hold a match
+        # By the triangle inequality, a member can be no closer to the query
+        # than its leader distance minus the cluster radius
+        candidates = numpy.nonzero(
+            leader_distances - self._index_radii[:self._index_cluster_count] < threshold)[0]
+
+        # Gather the rows of all candidate cluster members
+        rows = []
+        fids = []
+        for cluster in candidates:
+            for member_fid in self._index_members[cluster]:
+                rows.append(self._identity_rows[member_fid])
+                fids.append(member_fid)
+
+        # Bail if every cluster was pruned
+        if not rows:
+            return -1, threshold
+
+        # Distances to the surviving candidates in one vectorized op
+        distances = numpy.linalg.norm(self._identity_matrix[rows] - ident, axis=1)
+
+        # The best surviving candidate
+        best = int(numpy.argmin(distances))
+
+        # Enforce the distance threshold
+        if distances[best] >= threshold:
+            return -1, threshold
+
+        return fids[best], float(distances[best])
+
+    def search(self, ident: numpy.ndarray, threshold: float) -> Tuple[int, float]:
+        """
+        Find the nearest known identity within a distance threshold.
+
+        The internal lock is held only for the vectorized lookup itself, so
+        concurrent recognizers on different robots barely contend.
+
+        :param ident: The query identity
+        :param threshold: The maximum tolerable distance
+        :return: A (face ID, distance) pair, with face ID -1 on no match
+        """
+
+        with self._identities_lock:
+            return self._index_search(ident, threshold)
+
+
 class ServiceFace(Service):
     """
     The face service recognizes faces.
     """
 
-    def __init__(self):
+    def __init__(self, identity_store: FaceIdentityStore = None, detector_backend: str = 'hog',
+                 cnn_model_path: str = None, downscale_first: bool = True, log=print):
+        """
+        Initialize the face service.
+
+        :param identity_store: The identity store to use, or None to create a
+                               private one (pass a shared store so multiple
+                               robots recognize from one copy of the data)
+        :param detector_backend: The detector backend, 'hog' (CPU) or 'cnn'
+                                 (needs a GPU build of dlib to be fast)
+        :param cnn_model_path: Path to the mmod CNN detector model (required
+                               for the 'cnn' backend)
+        :param downscale_first: Whether to search a downscaled pyramid level
+                                first and only revisit candidate regions at
+                                high resolution
+        :param log: A callable taking one line of diagnostic output (the
+                    operation injects its terminal logger here)
+        """
+
         super().__init__()
 
-        # The face identities
-        self._identities: Dict[int, Tuple[float, ...]] = {}
-        self._identities_lock = Lock()
+        # The face identity store
+        self._identities = identity_store if identity_store is not None else FaceIdentityStore()
+
+        # The diagnostic log callable
+        self._log = log
+
+        # The detection strategy
+        self._detector_backend = detector_backend
+        self._downscale_first = downscale_first
+
+        # The detector instance for this service
+        if detector_backend == 'cnn':
+            # The CNN detector needs its model supplied by the caller
+            if cnn_model_path is None:
+                raise ValueError('the cnn detector backend requires cnn_model_path')
+            self._detector = dlib.cnn_face_detection_model_v1(cnn_model_path)
+        elif detector_backend == 'hog':
+            # The module-wide HOG detector is shared and resolved lazily
+            self._detector = None
+        else:
+            raise ValueError(f'unknown detector backend "{detector_backend}"')
+
+        # The incoming frame ring
+        # The camera callback appends here in O(1) and a dedicated worker
+        # thread does the actual preprocessing and tracker maintenance, so
+        # the Cozmo SDK never waits on us and memory stays bounded under load
+        self._frame_ring = deque(maxlen=_frame_ring_capacity)
+        self._frame_ring_lock = Lock()
+        self._frame_avail = Event()
+        self._frames_dropped = 0
+
+        # The frame worker thread
+        self._thread_frames = None
+
+        # A kill switch for the frame worker loop
+        self._frame_kill = False
+        self._frame_kill_lock = Lock()
 
         # The detection thread
         # We only need one of these, as each detection operation finds all faces in a frame
@@ -129,17 +662,38 @@ class ServiceFace(Service):
         self._detection_kill = False
         self._detection_kill_lock = Lock()
 
+        # A wakeup signal for the detection loop
+        # This is set when there is fresh demand for detection, so the loop
+        # never sleeps through a waiting caller
+        self._detection_wakeup = Event()
+
         # The recognition thread pool executor
         # A thread pool executor is a step above a simple thread pool, as it has a built-in work queue
         # This allows us to submit work orders for recognizing individual faces without worrying about scheduling
         self._thread_pool_recognizers = ThreadPoolExecutor(max_workers=3)  # FIXME: Allow this to be set by the user
 
         # The individual face trackers
+        # The trackers lock guards only the maps themselves; each tracker has
+        # its own lock, so updates fan out across the pool without recognizers
+        # stalling behind an unrelated tracker
         self._trackers = {}
-        self._tracker_images = {}
+        self._tracker_rois = {}  # Tracker ID -> (cropped ROI, frame-space origin)
+        self._tracker_locks: Dict[int, Lock] = {}
         self._trackers_lock = Lock()
         self._next_tracker_id = 0
 
+        # The tracker update thread pool executor
+        # Correlation updates for separate faces are independent, so track
+        # maintenance scales with cores
+        self._thread_pool_trackers = ThreadPoolExecutor(max_workers=4)  # FIXME: Allow this to be set by the user
+
+        # The per-track recognition memo
+        # A stable track keeps producing the same face, so the last embedding
+        # and match are remembered per tracker and handed back until the box
+        # drifts materially (no point re-running the ResNet on the same pixels)
+        self._recognition_memo: Dict[int, Tuple[dlib.rectangle, numpy.ndarray, int]] = {}
+        self._recognition_memo_lock = Lock()
+
         # The latest frame pending detection
         self._pending_detection = None
         self._pending_detection_flag = False
@@ -151,26 +705,32 @@ class ServiceFace(Service):
 
     def add_identity(self, fid: int, ident: Tuple[float, ...]):
         """
-        Add a new face identity to the tracker.
+        Add a new face identity to the underlying store.
 
         :param fid: The face ID
         :param ident: The face identity (128-dimensional vector)
         """
 
-        with self._identities_lock:
-            # Map the identity
-            self._identities[fid] = ident
+        self._identities.add_identity(fid, ident)
+
+    def add_identities(self, fids: List[int], idents: numpy.ndarray):
+        """
+        Add a batch of face identities to the underlying store.
+
+        :param fids: The face IDs, one per row of idents
+        :param idents: The face identities as an N-by-128 matrix
+        """
+
+        self._identities.add_identities(fids, idents)
 
     def remove_identity(self, fid: int):
         """
-        Remove a face identity from the tracker.
+        Remove a face identity from the underlying store.
 
         :param fid: The face ID
         """
 
-        with self._identities_lock:
-            # Unmap the identity
-            del self._identities[fid]
+        self._identities.remove_identity(fid)
 
     def start(self):
         """
@@ -179,10 +739,18 @@ class ServiceFace(Service):
 
         super().start()
 
+        with self._frame_kill_lock:
+            # Lock, clear, and unlock the frame worker kill switch
+            self._frame_kill = False
+
         with self._detection_kill_lock:
             # Lock, clear, and unlock the detection loop kill switch
             self._detection_kill = False
 
+        # Start the frame worker thread
+        self._thread_frames = Thread(target=self._thread_frames_main)
+        self._thread_frames.start()
+
         # Start the detection thread
         self._thread_detection = Thread(target=self._thread_detection_main)
         self._thread_detection.start()
@@ -194,10 +762,21 @@ class ServiceFace(Service):
 
         super().stop()
 
+        with self._frame_kill_lock:
+            # Lock, set, and unlock the frame worker kill switch
+            self._frame_kill = True
+
         with self._detection_kill_lock:
             # Lock, set, and unlock the detection loop kill switch
             self._detection_kill = True
 
+        # Kick both loops awake so they notice their kill switches
+        self._frame_avail.set()
+        self._detection_wakeup.set()
+
+        # Wait for the frame worker thread to die
+        self._thread_frames.join()
+
         # Wait for the detection thread to die
         self._thread_detection.join()
 
@@ -205,47 +784,149 @@ class ServiceFace(Service):
         """
         Update with the next image in the stream.
 
+        This is called on the Cozmo SDK's camera callback thread, so it does
+        no work beyond an O(1) append. If the ring is full, the oldest frame
+        is dropped to make room.
+
         :param image: The next frame
         """
 
-        # Convert to numpy matrix
-        image_np = numpy.array(image)
+        instrumentation.count('face.frames.in')
+
+        with self._frame_ring_lock:
+            # Count a drop if the ring is about to push out its oldest frame
+            if len(self._frame_ring) == self._frame_ring.maxlen:
+                self._frames_dropped += 1
+                instrumentation.count('face.frames.dropped')
 
-        # Prepare the image
-        # TODO: Factor this out
-        image_np = cv2.pyrUp(image_np)
-        image_np = cv2.medianBlur(image_np, 3)
+            # Append the frame (the deque drops the oldest for us)
+            self._frame_ring.append(image)
+
+        # Wake the frame worker
+        self._frame_avail.set()
+
+    @property
+    def frames_dropped(self) -> int:
+        """
+        :return: The number of frames dropped from the incoming ring
+        """
+        return self._frames_dropped
+
+    def _process_frame(self, image: PIL.Image):
+        """
+        Process one frame from the ring.
+
+        This runs on the frame worker thread.
+
+        :param image: The frame to process
+        """
+
+        # Prepare the image exactly once
+        # Both the trackers and the detection thread share this copy
+        image_np = _prepare_frame(image)
 
         with self._trackers_lock:
-            # IDs of trackers that need pruning because faces have left us
-            doomed_tracker_ids = []
+            # Snapshot the registered trackers
+            tracker_items = list(self._trackers.items())
+
+        def update_one(tracker_id, tracker):
+            """Update one tracker under its own lock and report its quality."""
+            with self._tracker_locks[tracker_id]:
+                quality = tracker.update(image_np)
+
+                # Keep just a padded crop around the new position
+                # This is what recognition reads, and it's a fraction of the frame
+                box = tracker.get_position()
+                self._tracker_rois[tracker_id] = _crop_roi(
+                    image_np, box.left(), box.top(), box.right(), box.bottom())
+            return tracker_id, quality
+
+        # Fan the updates out across the tracker pool
+        update_futures = [self._thread_pool_trackers.submit(update_one, tracker_id, tracker)
+                          for (tracker_id, tracker) in tracker_items]
 
-            # For each registered tracker...
-            for tracker_id in self._trackers.keys():
-                # ...update it with the image!
-                quality = self._trackers[tracker_id].update(image_np)
-                self._tracker_images[tracker_id] = image_np
+        # IDs of trackers that need pruning because faces have left us
+        doomed_tracker_ids = []
 
-                # Doom the trackers with low quality tracks
-                if quality < 7:  # TODO: Allow user to set this
-                    doomed_tracker_ids.append(tracker_id)
+        # Collect the results
+        for update_future in update_futures:
+            tracker_id, quality = update_future.result()
 
+            # Doom the trackers with low quality tracks
+            if quality < 7:  # TODO: Allow user to set this
+                doomed_tracker_ids.append(tracker_id)
+
+        with self._trackers_lock:
             # Prune the doomed trackers
             for tracker_id in doomed_tracker_ids:
                 self._trackers.pop(tracker_id, None)
-                self._tracker_images.pop(tracker_id, None)
+                self._tracker_rois.pop(tracker_id, None)
+                self._tracker_locks.pop(tracker_id, None)
+
+        with self._recognition_memo_lock:
+            # Forget remembered recognitions for pruned trackers
+            for tracker_id in doomed_tracker_ids:
+                self._recognition_memo.pop(tracker_id, None)
+
+        if doomed_tracker_ids:
+            instrumentation.count('face.tracks.pruned', len(doomed_tracker_ids))
 
         with self._pending_detection_lock:
             # Update pending detection frame
-            self._pending_detection = image
+            # We hand over the already-prepared frame, so the detection thread
+            # does not repeat the conversion and preprocessing
+            self._pending_detection = image_np
             self._pending_detection_flag = True
 
-    def next_track(self):
+        with self._next_track_futures_lock:
+            # Whether a caller is waiting on a new track
+            demand = len(self._next_track_futures) > 0
+
+        # If there is demand, wake the detection loop for this frame
+        # Without demand the loop keeps its own (backed-off) cadence
+        if demand:
+            self._detection_wakeup.set()
+
+    def _thread_frames_main(self):
+        """
+        Main function for the frame worker.
+
+        This drains the incoming frame ring and does the preprocessing and
+        tracker maintenance that used to run on the camera callback thread.
         """
-        Obtain a future on the next initiated face track. This does not notify
-        of any preexisting tracks.
 
-        :return: A future for the next DetectedFace object
+        while True:
+            with self._frame_kill_lock:
+                # Test kill switch
+                if self._frame_kill:
+                    break
+
+            # The next frame off the ring (oldest first)
+            image: PIL.Image = None
+
+            with self._frame_ring_lock:
+                if self._frame_ring:
+                    image = self._frame_ring.popleft()
+
+            # If the ring was empty, sleep until a frame arrives
+            if image is None:
+                self._frame_avail.wait()
+                self._frame_avail.clear()
+                continue
+
+            # Process the frame
+            with instrumentation.timed('face.frame_process'):
+                self._process_frame(image)
+
+    async def next_track(self) -> DetectedFace:
+        """
+        Await the next initiated face track. This does not notify of any
+        preexisting tracks.
+
+        The result is bridged from the detection thread with a thread-safe
+        wakeup, so awaiting adds no polling overhead.
+
+        :return: The next DetectedFace object
         """
 
         # Create a future for the detection (they say we're not supposed to call this)
@@ -257,17 +938,90 @@ class ServiceFace(Service):
             # Lock, append the future to, and unlock the next track futures list
             self._next_track_futures.append(future)
 
-        return future
+        # Wake the detection loop, as somebody is now waiting on it
+        self._detection_wakeup.set()
 
-    def recognize(self, index: int):
+        # Sleep until the detection thread completes the future
+        # wrap_future wakes the loop through call_soon_threadsafe
+        return await asyncio.wrap_future(future)
+
+    async def recognize(self, index: int) -> Optional[RecognizedFace]:
         """
-        Obtain a future on the recognition of a face track.
+        Await the recognition of a face track.
 
         :param index: The track index
+        :return: The RecognizedFace object, or None if the track vanished
         """
 
         # Send off a request to recognize the face in this track
-        return self._thread_pool_recognizers.submit(self._recognize_main, index)
+        # Awaiting the wrapped future wakes the loop exactly when it lands
+        return await asyncio.wrap_future(self._thread_pool_recognizers.submit(self._recognize_main, index))
+
+    def _run_detector(self, image_np: numpy.ndarray, upsample: int) -> List[dlib.rectangle]:
+        """
+        Run the configured detector backend over an image.
+
+        :param image_np: The image to search
+        :param upsample: How many times to upsample before searching
+        :return: The detected face rectangles
+        """
+
+        # The CNN detector is per-service; the HOG one is shared module-wide
+        detector = self._detector if self._detector is not None else _get_detector()
+
+        detections = detector(image_np, upsample)
+
+        # The CNN backend wraps its rectangles with a confidence
+        if self._detector_backend == 'cnn':
+            return [detection.rect for detection in detections]
+
+        return list(detections)
+
+    def _detect_faces(self, frame_np: numpy.ndarray) -> List[dlib.rectangle]:
+        """
+        Detect all faces in a prepared frame.
+
+        In downscale-first mode the search runs on a half-resolution pyramid
+        level and only candidate regions are revisited at full resolution,
+        which cuts the detection pass cost by an order of magnitude.
+
+        :param frame_np: The prepared (2x upscaled) frame
+        :return: The detected face rectangles in prepared-frame coordinates
+        """
+
+        # The classic single-pass mode: search the full prepared frame with
+        # an extra upsample on top (expensive, but nothing gets missed)
+        if not self._downscale_first:
+            return self._run_detector(frame_np, 1)
+
+        # Drop back down a pyramid level (native camera resolution)
+        frame_small = numpy.ascontiguousarray(frame_np[::2, ::2])
+
+        # Search the cheap level for candidates
+        candidates = self._run_detector(frame_small, 0)
+
+        # The refined detections
+        faces: List[dlib.rectangle] = []
+
+        for candidate in candidates:
+            # The candidate box scaled up into prepared-frame coordinates
+            scaled = dlib.rectangle(candidate.left() * 2, candidate.top() * 2,
+                                    candidate.right() * 2, candidate.bottom() * 2)
+
+            # Revisit just this region at full resolution
+            roi, (roi_x, roi_y) = _crop_roi(frame_np, scaled.left(), scaled.top(), scaled.right(), scaled.bottom())
+            hits = self._run_detector(roi, 0)
+
+            if hits:
+                # Take the largest hit and shift it back into frame space
+                best = max(hits, key=lambda hit: hit.area())
+                faces.append(dlib.rectangle(best.left() + roi_x, best.top() + roi_y,
+                                            best.right() + roi_x, best.bottom() + roi_y))
+            else:
+                # Keep the coarse box; tracking is lenient about placement
+                faces.append(scaled)
+
+        return faces
 
     def _thread_detection_main(self):
         """
@@ -276,8 +1030,9 @@ class ServiceFace(Service):
         This runs all the time, and it picks up the latest image.
         """
 
-        # The latest frame
-        frame: PIL.Image = None
+        # The current detection interval (in seconds)
+        # This adapts to demand: fast while a caller waits, slow while idle
+        interval = _detection_interval_min
 
         while True:
             with self._detection_kill_lock:
@@ -285,6 +1040,9 @@ class ServiceFace(Service):
                 if self._detection_kill:
                     break
 
+            # The latest frame (already prepared by the update path)
+            frame: numpy.ndarray = None
+
             with self._pending_detection_lock:
                 # If a pending frame is available
                 if self._pending_detection_flag:
@@ -296,18 +1054,18 @@ class ServiceFace(Service):
                     self._pending_detection = None
                     self._pending_detection_flag = False
 
+            # The faces found this pass (if any)
+            faces: List[dlib.rectangle] = []
+
             # If we've got a frame to work with
             if frame is not None:
-                # Use the image as a numpy matrix
-                frame_np = numpy.array(frame)
-
-                # Prepare the image
-                # TODO: Factor this out
-                frame_np = cv2.pyrUp(frame_np)
-                frame_np = cv2.medianBlur(frame_np, 3)
+                # The frame was already prepared on the update path
+                # We share that copy instead of redoing the preprocessing
+                frame_np = frame
 
                 # Detect all faces in the image
-                faces: List[dlib.rectangle] = _detector(frame_np, 1)
+                with instrumentation.timed('face.detection'):
+                    faces = self._detect_faces(frame_np)
 
                 # Go over all detected faces
                 for face in faces:
@@ -318,8 +1076,9 @@ class ServiceFace(Service):
                     with self._trackers_lock:
                         # Loop through all outstanding trackers
                         for tracker_id in self._trackers.keys():
-                            # Get the current tracker position
-                            tracker_box = self._trackers[tracker_id].get_position()
+                            # Get the current tracker position under its own lock
+                            with self._tracker_locks[tracker_id]:
+                                tracker_box = self._trackers[tracker_id].get_position()
 
                             # Tracker box coordinates
                             tb_l = int(tracker_box.left())  # left of tracker box
@@ -362,9 +1121,7 @@ class ServiceFace(Service):
                             tracker_id = self._next_tracker_id
                             self._next_tracker_id += 1
 
-                            # Map the new tracker in
-                            self._trackers[tracker_id] = new_tracker
-                            self._tracker_images[tracker_id] = frame_np
+                            instrumentation.count('face.tracks.created')
 
                             # Add some padding to the face rectangle
                             # TODO: Make this slop configurable
@@ -373,6 +1130,12 @@ class ServiceFace(Service):
                             track_right = face.right() + 10
                             track_bottom = face.bottom() + 20
 
+                            # Map the new tracker in (with its own lock)
+                            self._trackers[tracker_id] = new_tracker
+                            self._tracker_rois[tracker_id] = _crop_roi(
+                                frame_np, track_left, track_top, track_right, track_bottom)
+                            self._tracker_locks[tracker_id] = Lock()
+
                             # Start tracking the new face in full color
                             new_tracker.start_track(frame_np,
                                                     dlib.rectangle(track_left, track_top, track_right, track_bottom))
@@ -384,12 +1147,47 @@ class ServiceFace(Service):
 
                             with self._next_track_futures_lock:
                                 # Complete all the next track futures
+                                # A caller cancelling its awaitable (greet does
+                                # on every activity change) cancels the wrapped
+                                # future too, and completing a done future
+                                # would kill this thread with InvalidStateError
                                 for future in self._next_track_futures:
-                                    future.set_result(detected)
+                                    if not future.done():
+                                        future.set_result(detected)
                                 self._next_track_futures.clear()
 
-            # Sleep for a bit
-            time.sleep(3)  # TODO: This should dynamically reduce during face diversion and scale back up otherwise
+            with self._next_track_futures_lock:
+                # Whether a caller is still waiting on a new track
+                demand = len(self._next_track_futures) > 0
+
+            if demand or len(faces) > 0:
+                # Somebody is waiting on us (or faces are in view), so run hot
+                interval = _detection_interval_min
+            elif frame is None or len(faces) == 0:
+                # No frames or no faces are arriving, so back off exponentially
+                interval = min(interval * 2, _detection_interval_max)
+
+            # Sleep out the interval, but let fresh demand cut it short
+            self._detection_wakeup.wait(timeout=interval)
+            self._detection_wakeup.clear()
+
+    @staticmethod
+    def _box_drift(a: dlib.rectangle, b: dlib.rectangle) -> float:
+        """
+        Measure how far one face box drifted from another.
+
+        The largest edge displacement is taken relative to the box size, so
+        both movement and resizing (which tracks quality changes) count.
+
+        :param a: The reference box
+        :param b: The box to compare against it
+        :return: The drift as a fraction of the reference box size
+        """
+
+        size = max(a.width(), a.height(), 1)
+        shift = max(abs(a.left() - b.left()), abs(a.top() - b.top()),
+                    abs(a.right() - b.right()), abs(a.bottom() - b.bottom()))
+        return shift / size
 
     def _recognize_main(self, index: int) -> Optional[RecognizedFace]:
         """
@@ -398,60 +1196,87 @@ class ServiceFace(Service):
         This runs to completion on an as-needed basis given by a thread pool.
         """
 
-        print(f'A recognition worker has kicked off for tracker {index}')
+        self._log(f'A recognition worker has kicked off for tracker {index}')
 
         with self._trackers_lock:
-            if self._trackers.get(index) is None:
-                print(f'Tracker {index} no longer exists')
+            # Look up the tracker, its lock, and its region of interest
+            # The ROI must come out under this lock too: pruning pops all
+            # three together, so a bare read after release could miss
+            tracker = self._trackers.get(index)
+            tracker_lock = self._tracker_locks.get(index)
+            tracker_roi = self._tracker_rois.get(index)
+
+            if tracker is None or tracker_roi is None:
+                self._log(f'Tracker {index} no longer exists')
                 return None
 
+        # Unpack the cropped region of interest and its frame-space origin
+        roi, (roi_x, roi_y) = tracker_roi
+
+        with tracker_lock:
             # Query the latest face bounding box from the tracker
-            position: dlib.rectangle = self._trackers[index].get_position()
+            # Only this tracker's lock is held, so unrelated updates proceed
+            position: dlib.rectangle = tracker.get_position()
 
-            # Get the image that corresponds to this tracker
-            image = self._tracker_images[index]
+        with self._recognition_memo_lock:
+            # Look up the last recognition remembered for this tracker
+            memo = self._recognition_memo.get(index)
 
-        print(f'Details gathered for tracker {index}; stand by for pose prediction...')
+        # If the track has been stable since we last recognized it
+        if memo is not None:
+            memo_box, memo_ident, memo_fid = memo
 
-        # Predict 68 unique points on the face
-        prediction = _predictor(image, dlib.rectangle(
-            int(position.left()),
-            int(position.top()),
-            int(position.right()),
-            int(position.bottom())
-        ))
+            if self._box_drift(memo_box, position) < _recognition_memo_max_drift:
+                self._log(f'Serving remembered recognition for stable tracker {index}')
+                instrumentation.count('face.recognitions.memoized')
 
-        print(f'Face pose prediction succeeded on tracker {index}; computing vector embedding...')
+                # Hand back the remembered result without touching the ResNet
+                rec = RecognizedFace()
+                rec.index = index
+                rec.coords = position
+                rec.fid = memo_fid
+                rec.ident = tuple(memo_ident)
+                return rec
 
-        # Compute the 128-dimensional vector embedding of the face
-        ident = numpy.array(_model.compute_face_descriptor(image, prediction, 1))
+        self._log(f'Details gathered for tracker {index}; stand by for pose prediction...')
 
-        print(f'Computed face embedding for tracker {index}; cross-referencing known faces...')
+        # Predict 68 unique points on the face
+        # The face box shifts into the crop's coordinate space
+        with instrumentation.timed('face.recognition.pose'):
+            prediction = _get_predictor()(roi, dlib.rectangle(
+                int(position.left()) - roi_x,
+                int(position.top()) - roi_y,
+                int(position.right()) - roi_x,
+                int(position.bottom()) - roi_y
+            ))
 
-        with self._identities_lock:
-            # Details about the best match
-            best_match_fid = -1  # Impossible by our definition of face IDs (valid only if >= 0)
-            best_match_distance = 0.6  # TODO: Make this user configurable (the maximum tolerance)
+        self._log(f'Face pose prediction succeeded on tracker {index}; computing vector embedding...')
 
-            for other_fid in self._identities.keys():
-                # The other full-blown identity (128-dim vector embedding)
-                other_ident = numpy.array(self._identities[other_fid])
+        # Compute the 128-dimensional vector embedding of the face
+        with instrumentation.timed('face.recognition.embed'):
+            ident = numpy.array(_get_model().compute_face_descriptor(roi, prediction, 1))
 
-                # In numpy, the norm of two vectors with ord=None and axis=1 is simply Euclidean distance
-                distance = numpy.linalg.norm([ident - other_ident], ord=None, axis=1)
+        self._log(f'Computed face embedding for tracker {index}; cross-referencing known faces...')
 
-                # If this is a new best distance
-                if distance < best_match_distance:
-                    # Update best match details
-                    best_match_fid = other_fid
-                    best_match_distance = distance
+        # Look up the nearest known identity through the shared store
+        # Whole clusters that provably cannot match are never touched
+        best_match_fid, best_match_distance = self._identities.search(
+            ident.astype(numpy.float32),
+            threshold=0.6,  # TODO: Make this user configurable (the maximum tolerance)
+        )
 
-        print(f'Cross-referencing for tracker {index} completed')
+        self._log(f'Cross-referencing for tracker {index} completed')
 
         if best_match_fid == -1:
-            print(f'The face for tracker {index} is not known')
+            self._log(f'The face for tracker {index} is not known')
         else:
-            print(f'The face for tracker {index} known as {best_match_fid} in the database')
+            self._log(f'The face for tracker {index} known as {best_match_fid} in the database')
+
+        with self._recognition_memo_lock:
+            # Remember the result for repeat recognitions of this track
+            self._recognition_memo[index] = (position, ident, best_match_fid)
+
+        instrumentation.count('face.recognitions')
 
         # Return info about the recognized face
         rec = RecognizedFace()
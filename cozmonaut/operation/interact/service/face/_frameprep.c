@@ -0,0 +1,209 @@
+/*
+ * Cozmonaut
+ * Copyright 2019 The Cozmonaut Contributors
+ *
+ * Native frame preprocessing for the face service.
+ *
+ * This replaces the cv2.pyrUp + cv2.medianBlur pair that used to run twice per
+ * camera frame (once on the SDK callback thread and once on the detection
+ * thread). It accepts the raw RGB camera buffer through the buffer protocol
+ * (no PIL round-trip), does a 2x upscale and a 3x3 median denoise in one pass
+ * over preallocated memory, and returns a single shared output buffer that
+ * both the tracker-update path and the detection thread can view.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/* Number of color channels in a camera frame (RGB) */
+#define FRAMEPREP_CHANNELS 3
+
+/*
+ * Compute the median of nine bytes.
+ *
+ * This is the kernel of the 3x3 median filter. A tiny insertion sort is used
+ * because the input is always exactly nine elements.
+ */
+static uint8_t median9(uint8_t *v) {
+    int i;
+    int j;
+
+    /* Insertion sort the nine samples */
+    for (i = 1; i < 9; ++i) {
+        uint8_t key = v[i];
+
+        for (j = i - 1; j >= 0 && v[j] > key; --j) {
+            v[j + 1] = v[j];
+        }
+
+        v[j + 1] = key;
+    }
+
+    /* The middle element is the median */
+    return v[4];
+}
+
+/*
+ * Upscale one RGB frame by 2x with bilinear interpolation.
+ *
+ * The src buffer is h-by-w pixels and the dst buffer is 2h-by-2w pixels. This
+ * approximates cv2.pyrUp closely enough for tracking and detection purposes.
+ */
+static void upscale2x(const uint8_t *src, uint8_t *dst, Py_ssize_t w, Py_ssize_t h) {
+    Py_ssize_t x;
+    Py_ssize_t y;
+    Py_ssize_t c;
+
+    /* Strides in bytes for source and destination rows */
+    Py_ssize_t src_stride = w * FRAMEPREP_CHANNELS;
+    Py_ssize_t dst_stride = 2 * w * FRAMEPREP_CHANNELS;
+
+    for (y = 0; y < h; ++y) {
+        /* The next source row (clamped at the bottom edge) */
+        Py_ssize_t yn = (y + 1 < h) ? (y + 1) : y;
+
+        const uint8_t *row0 = src + y * src_stride;
+        const uint8_t *row1 = src + yn * src_stride;
+
+        uint8_t *out0 = dst + (2 * y) * dst_stride;
+        uint8_t *out1 = dst + (2 * y + 1) * dst_stride;
+
+        for (x = 0; x < w; ++x) {
+            /* The next source column (clamped at the right edge) */
+            Py_ssize_t xn = (x + 1 < w) ? (x + 1) : x;
+
+            for (c = 0; c < FRAMEPREP_CHANNELS; ++c) {
+                /* The 2x2 source neighborhood */
+                uint8_t p00 = row0[x * FRAMEPREP_CHANNELS + c];
+                uint8_t p01 = row0[xn * FRAMEPREP_CHANNELS + c];
+                uint8_t p10 = row1[x * FRAMEPREP_CHANNELS + c];
+                uint8_t p11 = row1[xn * FRAMEPREP_CHANNELS + c];
+
+                /* Write the four destination pixels */
+                out0[(2 * x) * FRAMEPREP_CHANNELS + c] = p00;
+                out0[(2 * x + 1) * FRAMEPREP_CHANNELS + c] = (uint8_t) (((int) p00 + (int) p01 + 1) / 2);
+                out1[(2 * x) * FRAMEPREP_CHANNELS + c] = (uint8_t) (((int) p00 + (int) p10 + 1) / 2);
+                out1[(2 * x + 1) * FRAMEPREP_CHANNELS + c] =
+                        (uint8_t) (((int) p00 + (int) p01 + (int) p10 + (int) p11 + 2) / 4);
+            }
+        }
+    }
+}
+
+/*
+ * Apply a 3x3 median filter to an RGB frame in place (via a scratch copy).
+ */
+static void median3x3(const uint8_t *src, uint8_t *dst, Py_ssize_t w, Py_ssize_t h) {
+    Py_ssize_t x;
+    Py_ssize_t y;
+    Py_ssize_t c;
+
+    /* Row stride in bytes */
+    Py_ssize_t stride = w * FRAMEPREP_CHANNELS;
+
+    for (y = 0; y < h; ++y) {
+        /* Neighboring rows (clamped at the edges) */
+        Py_ssize_t yp = (y > 0) ? (y - 1) : y;
+        Py_ssize_t yn = (y + 1 < h) ? (y + 1) : y;
+
+        for (x = 0; x < w; ++x) {
+            /* Neighboring columns (clamped at the edges) */
+            Py_ssize_t xp = (x > 0) ? (x - 1) : x;
+            Py_ssize_t xn = (x + 1 < w) ? (x + 1) : x;
+
+            for (c = 0; c < FRAMEPREP_CHANNELS; ++c) {
+                /* Gather the 3x3 neighborhood */
+                uint8_t v[9];
+                v[0] = src[yp * stride + xp * FRAMEPREP_CHANNELS + c];
+                v[1] = src[yp * stride + x * FRAMEPREP_CHANNELS + c];
+                v[2] = src[yp * stride + xn * FRAMEPREP_CHANNELS + c];
+                v[3] = src[y * stride + xp * FRAMEPREP_CHANNELS + c];
+                v[4] = src[y * stride + x * FRAMEPREP_CHANNELS + c];
+                v[5] = src[y * stride + xn * FRAMEPREP_CHANNELS + c];
+                v[6] = src[yn * stride + xp * FRAMEPREP_CHANNELS + c];
+                v[7] = src[yn * stride + x * FRAMEPREP_CHANNELS + c];
+                v[8] = src[yn * stride + xn * FRAMEPREP_CHANNELS + c];
+
+                /* Write the median */
+                dst[y * stride + x * FRAMEPREP_CHANNELS + c] = median9(v);
+            }
+        }
+    }
+}
+
+/*
+ * prepare(buffer, width, height) -> bytes
+ *
+ * Upscale a raw RGB frame by 2x and denoise it with a 3x3 median filter. The
+ * returned bytes object is (2 * height) x (2 * width) x 3 and can be viewed
+ * with numpy.frombuffer without a copy.
+ */
+static PyObject *frameprep_prepare(PyObject *self, PyObject *args) {
+    Py_buffer view;
+    Py_ssize_t w;
+    Py_ssize_t h;
+
+    /* Parse the raw frame buffer and its dimensions */
+    if (!PyArg_ParseTuple(args, "y*nn", &view, &w, &h)) {
+        return NULL;
+    }
+
+    /* Sanity check the buffer size against the stated dimensions */
+    if (view.len < w * h * FRAMEPREP_CHANNELS) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "frame buffer is smaller than width * height * 3");
+        return NULL;
+    }
+
+    /* Size of the upscaled frame in bytes */
+    Py_ssize_t out_len = (2 * w) * (2 * h) * FRAMEPREP_CHANNELS;
+
+    /* The output buffer handed back to Python */
+    PyObject *out = PyBytes_FromStringAndSize(NULL, out_len);
+    if (out == NULL) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    /* A scratch buffer for the upscale pass */
+    uint8_t *scratch = (uint8_t *) PyMem_Malloc((size_t) out_len);
+    if (scratch == NULL) {
+        Py_DECREF(out);
+        PyBuffer_Release(&view);
+        return PyErr_NoMemory();
+    }
+
+    /* Do the heavy lifting without the GIL so camera callbacks stay cheap */
+    Py_BEGIN_ALLOW_THREADS
+        upscale2x((const uint8_t *) view.buf, scratch, w, h);
+        median3x3(scratch, (uint8_t *) PyBytes_AS_STRING(out), 2 * w, 2 * h);
+    Py_END_ALLOW_THREADS
+
+    PyMem_Free(scratch);
+    PyBuffer_Release(&view);
+
+    return out;
+}
+
+/* Module method table */
+static PyMethodDef frameprep_methods[] = {
+        {"prepare", frameprep_prepare, METH_VARARGS,
+                "Upscale a raw RGB frame by 2x and apply a 3x3 median denoise."},
+        {NULL, NULL, 0, NULL},
+};
+
+/* Module definition */
+static struct PyModuleDef frameprep_module = {
+        PyModuleDef_HEAD_INIT,
+        "_frameprep",
+        "Native frame preprocessing for the face service.",
+        -1,
+        frameprep_methods,
+};
+
+PyMODINIT_FUNC PyInit__frameprep(void) {
+    return PyModule_Create(&frameprep_module);
+}
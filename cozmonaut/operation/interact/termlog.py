@@ -0,0 +1,205 @@
+#
+# Cozmonaut
+# Copyright 2019 The Cozmonaut Contributors
+#
+
+import threading
+from collections import deque
+from threading import Event, Lock, Thread
+
+from cozmonaut.operation.interact import instrumentation
+
+# The capacity of each per-thread line ring
+_ring_capacity = 512
+
+# How often the writer flushes queued lines (in seconds)
+_flush_interval = 0.25
+
+# The registry of per-thread rings
+# The lock guards only registration (once per thread ever); each ring has a
+# single producer (its thread) and a single consumer (the writer), and deque
+# append/popleft are atomic under the GIL, so the hot path takes no lock
+_rings = []
+_rings_lock = Lock()
+_ring_local = threading.local()
+
+# Per-subsystem verbosity (missing means enabled)
+_verbosity = {}
+
+# Every subsystem tag we've ever seen (for the terminal listing)
+_seen_subsystems = set()
+
+# The sink and writer thread
+_sink = None
+_thread: Thread = None
+_evt_stop = Event()
+
+
+def _ring() -> deque:
+    """
+    Get (or lazily create and register) the calling thread's line ring.
+
+    :return: The ring for this thread
+    """
+
+    ring = getattr(_ring_local, 'ring', None)
+
+    if ring is None:
+        ring = _ring_local.ring = deque()
+
+        with _rings_lock:
+            _rings.append(ring)
+
+    return ring
+
+
+def set_verbosity(subsystem: str, enabled: bool):
+    """
+    Turn a subsystem's log lines on or off.
+
+    :param subsystem: The subsystem tag
+    :param enabled: Whether its lines should print
+    """
+
+    _verbosity[subsystem] = bool(enabled)
+    _seen_subsystems.add(subsystem)
+
+
+def verbosity(subsystem: str) -> bool:
+    """
+    Test whether a subsystem's log lines are on.
+
+    :param subsystem: The subsystem tag
+    :return: True if its lines print, otherwise False
+    """
+
+    return _verbosity.get(subsystem, True)
+
+
+def subsystems() -> list:
+    """
+    List every subsystem tag seen so far.
+
+    :return: A sorted list of subsystem tags
+    """
+
+    return sorted(_seen_subsystems)
+
+
+def emit(subsystem: str, text: str):
+    """
+    Queue one log line for the terminal.
+
+    This is the hot-path half: a verbosity check and one ring append, no
+    locks. A disabled subsystem costs a counter bump and nothing else, and
+    a full ring drops the line rather than block the caller.
+
+    :param subsystem: The subsystem tag
+    :param text: The line to print
+    """
+
+    _seen_subsystems.add(subsystem)
+
+    # A disabled subsystem compiles down to a counter increment
+    if not _verbosity.get(subsystem, True):
+        instrumentation.count(f'log.suppressed.{subsystem}')
+        return
+
+    ring = _ring()
+
+    # If the writer fell badly behind, drop rather than grow without bound
+    if len(ring) >= _ring_capacity:
+        instrumentation.count('log.lines.dropped')
+        return
+
+    ring.append(text)
+
+
+def start(sink=None):
+    """
+    Start the background log writer.
+
+    :param sink: A callable taking a list of lines per flush, or None to
+                 print them plainly
+    """
+
+    global _sink, _thread
+
+    _sink = sink
+    _evt_stop.clear()
+
+    _thread = Thread(target=_thread_writer_main, name='TermLog', daemon=True)
+    _thread.start()
+
+
+def stop():
+    """
+    Stop the background log writer.
+
+    Lines still queued are flushed before the writer exits.
+    """
+
+    global _sink, _thread
+
+    if _thread is None:
+        return
+
+    # Signal the writer and wait for it to drain and die
+    _evt_stop.set()
+    _thread.join()
+    _thread = None
+    _sink = None
+
+
+def _drain() -> list:
+    """
+    Pop every queued line out of every ring.
+
+    :return: The drained lines
+    """
+
+    lines = []
+
+    with _rings_lock:
+        rings = list(_rings)
+
+    for ring in rings:
+        while True:
+            try:
+                lines.append(ring.popleft())
+            except IndexError:
+                break
+
+    return lines
+
+
+def _flush():
+    """
+    Drain the rings and deliver the batch to the sink.
+    """
+
+    lines = _drain()
+
+    if not lines:
+        return
+
+    sink = _sink
+
+    if sink is not None:
+        # One sink call (and so one terminal alert) for the whole batch
+        sink(lines)
+    else:
+        for line in lines:
+            print(line)
+
+
+def _thread_writer_main():
+    """
+    Main function for the log writer thread.
+    """
+
+    # Flush once per interval until stopped, then drain the stragglers
+    while not _evt_stop.wait(_flush_interval):
+        _flush()
+
+    _flush()
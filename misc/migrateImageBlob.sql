@@ -0,0 +1,9 @@
+-- Migration: store face embeddings as packed little-endian float32 blobs
+-- (~512 bytes per face) instead of JSON text (~3 KB per face)
+--
+-- Run this once against an existing database. Fresh installs don't need
+-- it, since tableSQL.sql already creates the column as a blob.
+
+use Cozmo;
+
+alter table Students modify column Image blob not null;
@@ -5,7 +5,7 @@
 
 import os
 
-from setuptools import find_packages, setup
+from setuptools import Extension, find_packages, setup
 
 
 def load_version():
@@ -40,6 +40,15 @@ setup(
     author='The Cozmonauts',
     url='https://github.com/cozmonauts/app',
     packages=find_packages(exclude=['venv']),
+    ext_modules=[
+        # Native frame preprocessing for the face service
+        # This is optional, and the face service falls back to OpenCV without it
+        Extension(
+            name='cozmonaut.operation.interact.service.face._frameprep',
+            sources=['cozmonaut/operation/interact/service/face/_frameprep.c'],
+            optional=True,
+        ),
+    ],
     python_requires='>=3.6.0',
     install_requires=[
         'cmd2',